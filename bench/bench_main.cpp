@@ -0,0 +1,338 @@
+/**
+ * @file bench_main.cpp
+ * @brief Cycle-count micro-benchmarks for the firmware hot paths
+ * @version 1.0.0
+ *
+ * Built by env:bench_uno / env:bench_mega in place of main.cpp and run in
+ * simavr by tools/run_bench.py. Timer1 runs free at F_CPU, so every
+ * timer tick is one CPU cycle; an overflow interrupt extends it to 32
+ * bits. Results are printed over the UART as
+ *
+ *     BENCH <name> calls=<n> cycles=<cycles per call>
+ *
+ * after which the CPU sleeps with interrupts off, which makes simavr exit.
+ * Servos are never attached, so Timer1 is free on both boards.
+ */
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <Otto.h>
+#include <TrajectoryPlanner.h>
+#include <PlayRtttl.hpp>
+
+#include "config.h"
+#include "led_controller.h"
+#include "led_effects.h"
+#include "command_parser.h"
+#include "melodies.h"
+#include "melodies_compiled.h"
+
+// =============================================================================
+// CYCLE COUNTER
+// =============================================================================
+
+static volatile uint16_t timerOverflows = 0;
+
+ISR(TIMER1_OVF_vect) {
+    timerOverflows++;
+}
+
+/**
+ * @brief Start Timer1 as a free-running cycle counter
+ */
+static void startCycleCounter() {
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);     // Normal mode, no prescaler
+    TCNT1 = 0;
+    TIFR1 = _BV(TOV1);
+    TIMSK1 = _BV(TOIE1);
+}
+
+/**
+ * @brief Read the 32-bit cycle count
+ */
+static uint32_t cycles() {
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t low = TCNT1;
+    uint16_t high = timerOverflows;
+    // Overflow happened after cli() but before the read
+    if ((TIFR1 & _BV(TOV1)) && low < 0x8000) high++;
+    SREG = sreg;
+    return ((uint32_t)high << 16) | low;
+}
+
+// =============================================================================
+// FIXTURES
+// =============================================================================
+
+LEDController leds(PIN_NEOPIXEL_1, PIN_NEOPIXEL_2, NUM_PIXELS);
+RtttlPlayer player;
+CommandParser commands;
+
+/**
+ * @brief Otto with its oscillator step exposed
+ */
+class BenchOtto : public Otto {
+public:
+    BenchOtto(MotionController& motion) : Otto(motion) {}
+    using Otto::_oscillate;
+};
+MotionController motion;
+BenchOtto otto(motion);
+TrajectoryPlanner planner;
+
+/**
+ * @brief Stream that replays a fixed block of serial input forever
+ */
+class ReplayStream : public Stream {
+public:
+    explicit ReplayStream(const char* text) : _text(text), _pos(0) {}
+
+    int available() override { return 1; }
+    int read() override {
+        char c = _text[_pos++];
+        if (_text[_pos] == '\0') _pos = 0;
+        return c;
+    }
+    int peek() override { return _text[_pos]; }
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    const char* _text;
+    uint8_t _pos;
+};
+
+// Effects are timed on a bare strip resized to each benchmark length
+Adafruit_NeoPixel effectStrip(0, PIN_NEOPIXEL_1, NEO_GRB + NEO_KHZ800);
+LEDEffectParams effectParams = { Colors::MAGENTA, Colors::BLACK, 20, 128 };
+LEDEffect benchEffect = LEDEffect::CHASE;
+
+ReplayStream serialInput("dope\nchill\nstartup\nstats\nxyzzy\n");
+
+static uint8_t benchStep = 0;
+static uint32_t benchNow = 0;
+static volatile uint8_t benchSink;      // Keeps pure results from being optimised out
+
+// =============================================================================
+// BENCHMARKS
+// =============================================================================
+
+static void benchEmpty() {
+}
+
+static void benchLedSetColor() {
+    // Alternate so every call pushes a new frame to both strips
+    benchStep ^= 1;
+    leds.setColor(benchStep ? 255 : 0, 0, benchStep ? 0 : 255);
+    leds.flush();
+}
+
+static void benchLedSetColorSame() {
+    // Redundant write: dirty tracking should make this nearly free
+    leds.setColor(255, 0, 255);
+    leds.flush();
+}
+
+static void benchLedAnimationFrame() {
+    benchNow += 10;
+    leds.update(benchNow);
+}
+
+static void benchLedFadeFrame() {
+    // One eased frame of a long fade; restart before it runs out
+    benchNow += 10;
+    if (!leds.update(benchNow)) {
+        leds.startFadeIn(Colors::MAGENTA, 60000);
+        benchNow = millis();
+    }
+}
+
+static void benchEffectFrame() {
+    // Shader pass only; show() time is fixed at 30 us per pixel
+    benchNow += 20;
+    renderEffect(benchEffect, effectParams, benchNow, effectStrip);
+}
+
+static void benchLayerBlend() {
+    // One overlay layer blended over an effect frame
+    blendPixels(effectStrip, Colors::WHITE, 160);
+}
+
+static void benchLedFlashFrame() {
+    // Composited frame of a fade with a notify flash over it
+    benchNow += 10;
+    if (!leds.isFlashing()) leds.flash(Colors::WHITE, 100, 50, 50, 160);
+    if (!leds.update(benchNow)) {
+        leds.startFadeIn(Colors::MAGENTA, 60000);
+        benchNow = millis();
+    }
+}
+
+static void benchHsv() {
+    // Walk hue and saturation so every sector is timed
+    benchStep += 37;
+    RGBColor color = hsvToRgb(benchStep, benchStep | 0x80, 200);
+    benchSink = color.r ^ color.g ^ color.b;
+}
+
+static void benchOttoOscillate() {
+    static int A[4] = {0, 0, 25, 25};
+    static int O[4] = {0, 0, 0, 0};
+    static uint16_t phase[4] = {0, 0, 0, 16384};
+    for (uint8_t i = 0; i < 4; i++) phase[i] += 1311;   // 50 steps per cycle
+    otto._oscillate(A, O, phase);
+}
+
+static void benchPlannerStep() {
+    // Keep long back-and-forth sweeps queued so every call is a real step
+    static bool up = false;
+    if (!planner.isFull()) {
+        up = !up;
+        planner.push(up ? 170 : 10);
+    }
+    benchSink = planner.step();
+}
+
+static void benchRtttlText() {
+    // Jump past the end of each note so every call decodes the next one
+    benchNow += 100000UL;
+    if (!player.update(benchNow)) player.startPGM(PIN_BUZZER, MELODY_DELLA);
+}
+
+static void benchRtttlCompiled() {
+    benchNow += 100000UL;
+    if (!player.update(benchNow)) player.startSong(PIN_BUZZER, SONG_DELLA);
+}
+
+static void benchSerialDispatch() {
+    // One full command line per call
+    while (commands.poll(serialInput) == SerialCommand::NONE) {
+    }
+}
+
+// =============================================================================
+// HARNESS
+// =============================================================================
+
+typedef void (*BenchFunction)();
+
+static uint32_t callOverhead = 0;
+
+/**
+ * @brief Time a benchmark and return average cycles per call
+ */
+static uint32_t measure(BenchFunction fn, uint16_t calls) {
+    Serial.flush();     // Keep UART interrupts out of the measurement
+    uint32_t start = cycles();
+    for (uint16_t i = 0; i < calls; i++) {
+        fn();
+    }
+    uint32_t total = cycles() - start;
+    uint32_t perCall = total / calls;
+    return perCall > callOverhead ? perCall - callOverhead : 0;
+}
+
+static void report(const __FlashStringHelper* name, BenchFunction fn, uint16_t calls) {
+    uint32_t perCall = measure(fn, calls);
+    Serial.print(F("BENCH "));
+    Serial.print(name);
+    Serial.print(F(" calls="));
+    Serial.print(calls);
+    Serial.print(F(" cycles="));
+    Serial.println(perCall);
+}
+
+/**
+ * @brief Time one frame of every effect at a strip length
+ */
+static void reportEffects(uint16_t pixels) {
+    static const char* const NAMES[] = {
+        "chase", "comet", "twinkle", "gradient", "vu_bar", "rainbow"
+    };
+    effectStrip.updateLength(pixels);
+    
+    for (uint8_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); i++) {
+        benchEffect = (LEDEffect)i;
+        uint32_t perCall = measure(benchEffectFrame, 16);
+        Serial.print(F("BENCH effect_"));
+        Serial.print(NAMES[i]);
+        Serial.print('_');
+        Serial.print(pixels);
+        Serial.print(F(" calls=16 cycles="));
+        Serial.println(perCall);
+    }
+    
+    uint32_t perCall = measure(benchLayerBlend, 16);
+    Serial.print(F("BENCH layer_blend_"));
+    Serial.print(pixels);
+    Serial.print(F(" calls=16 cycles="));
+    Serial.println(perCall);
+}
+
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    leds.begin();
+    startCycleCounter();
+
+    callOverhead = 0;
+    callOverhead = measure(benchEmpty, 256);
+
+    Serial.print(F("BENCH_BEGIN f_cpu="));
+    Serial.print(F_CPU);
+    Serial.print(F(" overhead="));
+    Serial.println(callOverhead);
+
+    report(F("led_set_color"), benchLedSetColor, 32);
+
+    leds.setOutputMode(LEDOutputMode::INDEPENDENT);
+    report(F("led_set_color_independent"), benchLedSetColor, 32);
+    leds.setOutputMode(LEDOutputMode::MIRROR);
+    report(F("led_set_color_same"), benchLedSetColorSame, 64);
+
+    leds.startRainbow(1, 10);
+    benchNow = millis();
+    report(F("led_animation_frame"), benchLedAnimationFrame, 64);
+    leds.stopAnimation();
+
+    leds.startFadeIn(Colors::MAGENTA, 60000);
+    benchNow = millis();
+    report(F("led_fade_frame"), benchLedFadeFrame, 64);
+    report(F("led_flash_frame"), benchLedFlashFrame, 64);
+    leds.clearLayer(LEDLayer::NOTIFY);
+
+    leds.startBreathe(Colors::MAGENTA, 100);
+    benchNow = millis();
+    report(F("led_breathe_frame"), benchLedAnimationFrame, 64);
+    leds.stopAnimation();
+    report(F("hsv_to_rgb"), benchHsv, 256);
+
+    reportEffects(7);
+    reportEffects(60);
+    reportEffects(150);
+    effectStrip.updateLength(0);
+
+    report(F("otto_oscillate"), benchOttoOscillate, 256);
+    report(F("planner_step"), benchPlannerStep, 256);
+
+    player.startPGM(PIN_BUZZER, MELODY_DELLA);
+    report(F("rtttl_text_note"), benchRtttlText, 64);
+
+    player.startSong(PIN_BUZZER, SONG_DELLA);
+    report(F("rtttl_compiled_note"), benchRtttlCompiled, 64);
+    player.stop();
+
+    report(F("serial_dispatch"), benchSerialDispatch, 64);
+
+    Serial.println(F("BENCH_END"));
+    Serial.flush();
+
+    // Sleeping with interrupts off ends the simavr run
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    cli();
+    sleep_cpu();
+}
+
+void loop() {
+}
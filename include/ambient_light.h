@@ -0,0 +1,59 @@
+/**
+ * @file ambient_light.h
+ * @brief Ambient light sensing for LED auto-dimming
+ * @version 1.0.0
+ */
+
+#ifndef SBOT_AMBIENT_LIGHT_H
+#define SBOT_AMBIENT_LIGHT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @class AmbientLight
+ * @brief Low-pass filtered LDR reading mapped to an LED brightness
+ * 
+ * Meant to be sampled at a low, steady rate (TASK_PERIOD_LIGHT). The
+ * filter is an exponential moving average kept with LIGHT_FILTER_SHIFT
+ * fractional bits, so a hand waved over the sensor or a flicker barely
+ * moves the result while a room going dark fades the LEDs down over a
+ * second or so. The level to brightness map is a linear ramp whose
+ * slope is worked out at compile time.
+ */
+class AmbientLight {
+public:
+    /**
+     * @brief Constructor
+     * @param pin Analog pin of the light sensor
+     */
+    AmbientLight(uint8_t pin);
+    
+    /**
+     * @brief Seed the filter with a first reading
+     */
+    void begin();
+    
+    /**
+     * @brief Take one reading and update the filter
+     * @return LED brightness for the filtered light level
+     */
+    uint8_t sample();
+    
+    /**
+     * @brief Get the filtered light level
+     * @return Level in analogRead() units (0-1023)
+     */
+    uint16_t getLevel() const { return _filtered >> LIGHT_FILTER_SHIFT; }
+    
+    /**
+     * @brief Get the brightness for the filtered light level
+     */
+    uint8_t getBrightness() const;
+
+private:
+    uint8_t _pin;
+    uint16_t _filtered;             // Level with LIGHT_FILTER_SHIFT fraction bits
+};
+
+#endif // SBOT_AMBIENT_LIGHT_H
@@ -0,0 +1,108 @@
+/**
+ * @file color_math.h
+ * @brief Fixed-point easing, gamma and interpolation helpers for LED effects
+ * @version 1.0.0
+ *
+ * Animation progress is a 16-bit fraction (0 = start, 0xFFFF = end).
+ * Easing curves are 33-point PROGMEM tables; a position picks a segment
+ * with its top 5 bits and interpolates inside it with an 8-bit fraction,
+ * so one eased value costs two flash reads and a multiply. Nothing here
+ * divides at run time: durations are turned into a per-ms rate once,
+ * when an animation starts, and hues are split into six sectors with a
+ * multiply by 6 instead of a divide by 42.5.
+ */
+
+#ifndef SBOT_COLOR_MATH_H
+#define SBOT_COLOR_MATH_H
+
+#include <stdint.h>
+#include "colors.h"
+
+/**
+ * @enum Easing
+ * @brief Curve applied to animation progress
+ */
+enum class Easing : uint8_t {
+    LINEAR,         // Straight ramp
+    EASE_IN_OUT,    // Slow start and end (half cosine)
+    GAMMA_IN,       // Perceptually even rise from black (gamma 2.6)
+    GAMMA_OUT,      // Perceptually even fall to black
+    SINE_BREATH     // Up and back down over one period, gamma corrected
+};
+
+#define COLOR_MATH_POSITION_MAX     0xFFFF
+
+/**
+ * @brief Color with 8.8 fixed-point channels (for temporal dithering)
+ */
+struct RGBColor16 {
+    uint16_t r;
+    uint16_t g;
+    uint16_t b;
+};
+
+/**
+ * @brief Progress rate for an animation of a given length
+ * @param durationMs Animation length in milliseconds
+ * @return Rate to pass to progressAt()
+ */
+uint32_t progressRate(uint32_t durationMs);
+
+/**
+ * @brief Progress of an animation after some time
+ * @param elapsedMs Time since the start, below the animation length
+ * @param rate Value from progressRate()
+ * @return Position (0-0xFFFF)
+ */
+inline uint16_t progressAt(uint32_t elapsedMs, uint32_t rate) {
+    // rate is 2^24 / duration, so the product stays below 2^24
+    return (uint16_t)((elapsedMs * rate) >> 8);
+}
+
+/**
+ * @brief Apply an easing curve to a position
+ * @param curve Easing curve
+ * @param position Linear position (0-0xFFFF)
+ * @return Eased position (0-0xFFFF)
+ */
+uint16_t ease(Easing curve, uint16_t position);
+
+/**
+ * @brief Interpolate between two colors
+ * @param from Color at position 0
+ * @param to Color at position 0xFFFF
+ * @param position Position (0-0xFFFF)
+ */
+RGBColor lerpColor(RGBColor from, RGBColor to, uint16_t position);
+
+/**
+ * @brief Interpolate between two colors, keeping 8 fractional bits
+ * @param from Color at position 0
+ * @param to Color at position 0xFFFF
+ * @param position Position (0-0xFFFF)
+ * @return Channels in 8.8 fixed point; both ends are exact
+ */
+RGBColor16 lerpColorFine(RGBColor from, RGBColor to, uint16_t position);
+
+/**
+ * @brief Convert a hue, saturation and value to RGB
+ * 
+ * Hue runs around the full wheel (0 = red, 85 = green, 170 = blue) with
+ * the brightest channel always at value, so a rotation keeps constant
+ * brightness. Every channel is within 1 LSB of float HSV.
+ * @param hue Hue (0-255)
+ * @param saturation Saturation (0 = white, 255 = pure hue)
+ * @param value Brightness (0-255)
+ */
+RGBColor hsvToRgb(uint8_t hue, uint8_t saturation = 255, uint8_t value = 255);
+
+/**
+ * @brief Scale a color by a level
+ * @param color Full-level color
+ * @param level Level (0-0xFFFF)
+ */
+inline RGBColor scaleColor(RGBColor color, uint16_t level) {
+    return lerpColor(Colors::BLACK, color, level);
+}
+
+#endif // SBOT_COLOR_MATH_H
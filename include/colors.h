@@ -2,83 +2,71 @@
  * @file colors.h
  * @brief Color definitions and presets for SBot LED system
  * @version 1.0.0
+ * 
+ * Preset colors are constexpr, so they fold into immediate operands and
+ * cost no RAM. Colors stored in flash are read with readColor(); color
+ * sequences are keyframe timelines (light_shows.h).
  */
 
 #ifndef SBOT_COLORS_H
 #define SBOT_COLORS_H
 
 #include <stdint.h>
+#include <avr/pgmspace.h>
 
 // =============================================================================
 // COLOR STRUCTURE
 // =============================================================================
 
 /**
- * @brief RGB color structure
+ * @brief RGB color structure (3 bytes, cheap to pass by value)
  */
 struct RGBColor {
     uint8_t r;
     uint8_t g;
     uint8_t b;
     
-    RGBColor(uint8_t red = 0, uint8_t green = 0, uint8_t blue = 0)
+    constexpr RGBColor(uint8_t red = 0, uint8_t green = 0, uint8_t blue = 0)
         : r(red), g(green), b(blue) {}
 };
 
+/**
+ * @brief Read a color stored in PROGMEM
+ * @param color Pointer into a PROGMEM color array
+ */
+inline RGBColor readColor(const RGBColor* color) {
+    return RGBColor(pgm_read_byte(&color->r),
+                    pgm_read_byte(&color->g),
+                    pgm_read_byte(&color->b));
+}
+
 // =============================================================================
 // PRESET COLORS
 // =============================================================================
 
 namespace Colors {
     // Basic colors
-    const RGBColor BLACK(0, 0, 0);
-    const RGBColor WHITE(255, 255, 255);
-    const RGBColor RED(255, 0, 0);
-    const RGBColor GREEN(0, 255, 0);
-    const RGBColor BLUE(0, 0, 255);
+    constexpr RGBColor BLACK(0, 0, 0);
+    constexpr RGBColor WHITE(255, 255, 255);
+    constexpr RGBColor RED(255, 0, 0);
+    constexpr RGBColor GREEN(0, 255, 0);
+    constexpr RGBColor BLUE(0, 0, 255);
     
     // Extended colors
-    const RGBColor MAGENTA(255, 0, 255);
-    const RGBColor MAGENTA_DIM(64, 0, 64);      // 25% magenta for chill state
-    const RGBColor CYAN(0, 255, 255);
-    const RGBColor YELLOW(255, 255, 0);
-    const RGBColor ORANGE(255, 127, 0);
-    const RGBColor PURPLE(128, 0, 128);
-    const RGBColor PINK(255, 105, 180);
+    constexpr RGBColor MAGENTA(255, 0, 255);
+    constexpr RGBColor MAGENTA_DIM(64, 0, 64);      // 25% magenta for chill state
+    constexpr RGBColor CYAN(0, 255, 255);
+    constexpr RGBColor YELLOW(255, 255, 0);
+    constexpr RGBColor ORANGE(255, 127, 0);
+    constexpr RGBColor PURPLE(128, 0, 128);
+    constexpr RGBColor PINK(255, 105, 180);
     
     // SBot mood colors
-    const RGBColor MOOD_HAPPY(255, 255, 0);     // Yellow - happy
-    const RGBColor MOOD_EXCITED(255, 0, 255);   // Magenta - excited
-    const RGBColor MOOD_CALM(64, 0, 64);        // Dim magenta - calm
-    const RGBColor MOOD_ALERT(255, 127, 0);     // Orange - alert
-    const RGBColor MOOD_ERROR(255, 0, 0);       // Red - error
+    constexpr RGBColor MOOD_HAPPY(255, 255, 0);     // Yellow - happy
+    constexpr RGBColor MOOD_EXCITED(255, 0, 255);   // Magenta - excited
+    constexpr RGBColor MOOD_CALM(64, 0, 64);        // Dim magenta - calm
+    constexpr RGBColor MOOD_ALERT(255, 127, 0);     // Orange - alert
+    constexpr RGBColor MOOD_ERROR(255, 0, 0);       // Red - error
 }
 
-// =============================================================================
-// COLOR SEQUENCES FOR ANIMATIONS
-// =============================================================================
-
-/**
- * @brief Dope state color sequence
- */
-const RGBColor DOPE_SEQUENCE[] = {
-    Colors::MAGENTA,    // Start
-    Colors::MAGENTA_DIM,// Chill
-    Colors::RED,        // Transition
-    Colors::ORANGE,     // Transition
-    Colors::YELLOW      // End
-};
-const uint8_t DOPE_SEQUENCE_LENGTH = sizeof(DOPE_SEQUENCE) / sizeof(RGBColor);
-
-/**
- * @brief Startup color sequence (rainbow fade)
- */
-const RGBColor STARTUP_SEQUENCE[] = {
-    Colors::RED,
-    Colors::GREEN,
-    Colors::BLUE,
-    Colors::WHITE
-};
-const uint8_t STARTUP_SEQUENCE_LENGTH = sizeof(STARTUP_SEQUENCE) / sizeof(RGBColor);
-
 #endif // SBOT_COLORS_H
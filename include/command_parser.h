@@ -0,0 +1,64 @@
+/**
+ * @file command_parser.h
+ * @brief Non-blocking serial command parser for SBot
+ * @version 1.0.0
+ */
+
+#ifndef SBOT_COMMAND_PARSER_H
+#define SBOT_COMMAND_PARSER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @enum SerialCommand
+ * @brief Commands understood on the serial console
+ */
+enum class SerialCommand : uint8_t {
+    NONE,           // No complete line yet
+    UNKNOWN,        // Line did not match any command
+    DOPE,           // Run dope state
+    CHILL,          // Run chill state
+    STARTUP,        // Run full startup sequence ("startup" or "demo")
+    HOME,           // Return to home position
+    HELP,           // Print the command list
+    STATS           // Print scheduler task statistics
+};
+
+/**
+ * @class CommandParser
+ * @brief Assembles serial lines byte by byte into a fixed buffer
+ * 
+ * poll() never blocks and never allocates: it consumes whatever bytes
+ * are already buffered and returns a command as soon as a newline
+ * completes one. Keywords are matched case-insensitively with a binary
+ * search over a sorted command table in PROGMEM.
+ */
+class CommandParser {
+public:
+    CommandParser();
+    
+    /**
+     * @brief Consume available input and dispatch a completed line
+     * @param input Stream to read from (usually Serial)
+     * @return Parsed command, or NONE if no line is complete yet
+     */
+    SerialCommand poll(Stream& input);
+    
+    /**
+     * @brief Discard any partially received line
+     */
+    void reset();
+
+private:
+    char _buffer[SERIAL_COMMAND_MAX_LENGTH + 1];
+    uint8_t _length;
+    bool _overflow;
+    
+    /**
+     * @brief Look up the buffered keyword in the command table
+     */
+    SerialCommand _lookup() const;
+};
+
+#endif // SBOT_COMMAND_PARSER_H
@@ -38,7 +38,9 @@
 
 #define PIN_NEOPIXEL_1    9   // D9 - Primary NeoPixel strip (left arm)
 #define PIN_NEOPIXEL_2    10  // D10 - Secondary NeoPixel strip (right arm)
-#define NUM_PIXELS        7   // Number of LEDs per strip
+#ifndef NUM_PIXELS
+#define NUM_PIXELS        7   // Number of LEDs per strip (up to 255)
+#endif
 
 // =============================================================================
 // SENSOR PIN DEFINITIONS
@@ -74,13 +76,48 @@
 #define ARM_LEFT_RAISED   130
 #define ARM_RIGHT_RAISED  60
 
+// Arm channels on the shared MotionController (Otto's legs use 0-3)
+#define ARM_CHANNEL_LEFT  4
+#define ARM_CHANNEL_RIGHT 5
+
+// Arm motion limits for planned moves
+#define ARM_MAX_SPEED     360   // deg/s
+#define ARM_MAX_ACCEL     1800  // deg/s^2
+
 // =============================================================================
 // TIMING CONSTANTS (in milliseconds)
 // =============================================================================
 
 #define SERVO_MOVE_DELAY      500   // Delay after servo movements
+#define ARM_SWAY_TIME         300   // Quick arm sway during a dance
 #define LED_FADE_STEP_DELAY   10    // Delay between LED fade steps
-#define MAIN_LOOP_DELAY       300   // Main loop iteration delay
+#define LED_MAX_FPS           50    // Cap on NeoPixel frames pushed per second
+#define LED_SERVO_SYNC_TIMEOUT_US 3000  // Longest wait for a servo quiet window
+#define LED_DITHER_FPS        100   // Refresh rate while dithering a fade
+#define LED_DITHER_BITS       3     // Fractional bits dithered (8-frame cycle)
+#define LED_EFFECT_BUDGET_US  5000  // Compute time allowed per effect frame
+#define LED_ACK_FLASH_MS      80    // Command acknowledgment flash length
+#define LED_ACK_ALPHA         160   // Opacity of the acknowledgment flash
+
+// Auto-dimming: LDR from 5V to PIN_LIGHT_SENSOR with 10k to GND, so the
+// reading rises with light. Brightness runs from LIGHT_BRIGHTNESS_MIN
+// at LIGHT_LEVEL_DARK up to full at LIGHT_LEVEL_BRIGHT.
+#define LIGHT_LEVEL_DARK      40    // analogRead() in a dark room
+#define LIGHT_LEVEL_BRIGHT    600   // analogRead() in a lit room
+#define LIGHT_BRIGHTNESS_MIN  32    // LED brightness in the dark
+#define LIGHT_FILTER_SHIFT    3     // Low-pass time constant: 2^n samples
+
+// =============================================================================
+// SCHEDULER TASK PERIODS (in milliseconds)
+// =============================================================================
+
+#define TASK_PERIOD_SERIAL    5     // Serial command input
+#define TASK_PERIOD_VOICE     50    // Voice module poll (I2C)
+#define TASK_PERIOD_LEDS      10    // LED animation frame
+#define TASK_PERIOD_SERVOS    10    // Servo interpolation step
+#define TASK_PERIOD_AUDIO     5     // Melody note advance
+#define TASK_PERIOD_LIGHT     100   // Ambient light sample (auto-dimming)
+#define TASK_DEADLINE_SLACK   20    // Lateness tolerated before a miss
 
 // =============================================================================
 // VOICE COMMAND IDs (DFRobot DF2301Q)
@@ -95,6 +132,7 @@
 // =============================================================================
 
 #define SERIAL_BAUD_RATE  115200
+#define SERIAL_COMMAND_MAX_LENGTH  15  // Longest accepted command line
 
 // =============================================================================
 // FEATURE FLAGS (Enable/Disable features at compile time)
@@ -106,6 +144,30 @@
 #define ENABLE_SOUND_EFFECTS    1   // Enable buzzer sounds
 #define ENABLE_DEBUG_OUTPUT     1   // Enable debug messages
 
+// Align NeoPixel show() with gaps between servo pulses (build with
+// -DENABLE_LED_SERVO_SYNC=0 to compare servo jitter without it)
+#ifndef ENABLE_LED_SERVO_SYNC
+#define ENABLE_LED_SERVO_SYNC   1
+#endif
+
+// Temporal dithering of LED fades (build with -DSBOT_LED_DITHER=0 to
+// drop its refresh frames and 10 bytes of RAM)
+#ifndef SBOT_LED_DITHER
+#define SBOT_LED_DITHER         1
+#endif
+
+// Dim the LEDs with the room light (needs the LDR on PIN_LIGHT_SENSOR;
+// build with -DENABLE_AUTO_DIM=1 once it is fitted)
+#ifndef ENABLE_AUTO_DIM
+#define ENABLE_AUTO_DIM         0
+#endif
+
+// Chain Otto's dance moves without a return home between them (build
+// with -DENABLE_MOTION_BLEND=0 to home after every move as before)
+#ifndef ENABLE_MOTION_BLEND
+#define ENABLE_MOTION_BLEND     1
+#endif
+
 // Debug macro
 #if ENABLE_DEBUG_OUTPUT
 #define DEBUG_PRINT(x)    Serial.print(x)
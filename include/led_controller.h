@@ -9,14 +9,131 @@
 
 #include <Adafruit_NeoPixel.h>
 #include "colors.h"
+#include "color_math.h"
+#include "light_shows.h"
+#include "led_effects.h"
 #include "config.h"
 
+/**
+ * @enum LEDAnimation
+ * @brief Animation currently run by the LED engine
+ */
+enum class LEDAnimation : uint8_t {
+    NONE,           // Static color, nothing to advance
+    FADE,           // Eased transition between two colors
+    RAINBOW,        // Hue wheel rotation
+    BREATHE,        // Fade in/out cycles of one color
+    TIMELINE,       // Keyframe light show from PROGMEM
+    EFFECT          // Per-pixel effect (led_effects.h)
+};
+
+/**
+ * @enum LEDLayer
+ * @brief Compositing layers, bottom to top
+ */
+enum class LEDLayer : uint8_t {
+    BASE,           // Mood color or animation (setColor, start*...)
+    OVERLAY,        // Transient tint over the base, e.g. an alert
+    NOTIFY          // Short flashes, e.g. a command acknowledgment
+};
+
+#define LED_OVERLAY_LAYERS  2   // Layers above BASE
+#define LED_FADE_STEPS      52  // Steps of the classic blocking fades
+
+/**
+ * @brief Color and opacity of one overlay layer
+ */
+struct LEDLayerState {
+    RGBColor color;
+    uint8_t alpha;          // 0 = transparent, 255 = opaque
+};
+
+/**
+ * @brief Called once when an animation runs to completion
+ */
+typedef void (*LEDAnimationCallback)();
+
+/**
+ * @enum LEDOutputMode
+ * @brief How the two arm strips are driven
+ */
+enum class LEDOutputMode : uint8_t {
+    MIRROR,         // One pixel buffer shown on both pins in turn
+    INDEPENDENT     // One buffer per strip, for per-arm effects
+};
+
+/**
+ * @class MirroredNeoPixel
+ * @brief NeoPixel strip whose single buffer can be sent to two pins
+ * 
+ * Keeps a separate latch timer for each pin, so moving to the other
+ * strip does not wait out the 300 us latch of the one just written.
+ */
+class MirroredNeoPixel : public Adafruit_NeoPixel {
+public:
+    MirroredNeoPixel(uint16_t n, int16_t pin, neoPixelType type)
+        : Adafruit_NeoPixel(n, pin, type)
+        , _otherEndTime(0) {
+    }
+    
+    /**
+     * @brief Point the output at another data pin
+     * @param pin New data pin
+     */
+    void swapPin(int16_t pin);
+
+private:
+    uint32_t _otherEndTime;     // Latch timer of the pin not in use
+};
+
 /**
  * @class LEDController
  * @brief Manages dual NeoPixel LED strips for SBot's arms
  * 
  * Provides methods for solid colors, fading, crossfading,
  * and animated patterns on both LED strips simultaneously.
+ * 
+ * Animations are non-blocking: a start*() call sets the effect up and
+ * update() advances it against millis(), so each loop tick costs only
+ * a few microseconds. The classic blocking methods (fadeIn, crossfade,
+ * rainbow...) are thin wrappers that run the same engine to completion.
+ * 
+ * Fades are time based: each frame looks its position up on a PROGMEM
+ * easing curve (color_math.h), so the cost per frame does not depend on
+ * the fade length. Fades to and from black follow a gamma curve, so the
+ * brightness looks like it changes evenly.
+ * 
+ * With SBOT_LED_DITHER, fades keep 8 fractional bits per channel and
+ * alternate between neighbouring 8-bit levels across frames, refreshed
+ * LED_DITHER_FPS times a second while a fraction is showing. This hides
+ * the steps of slow fades at low brightness.
+ * 
+ * Per-pixel effects (startEffect) write each pixel straight into the
+ * strip buffers, so longer strips (NUM_PIXELS) only cost their pixel
+ * buffer and the show() time: 30 us per pixel per strip.
+ * 
+ * Output is composited from a small layer stack: the BASE layer is
+ * everything above, OVERLAY and NOTIFY are solid colors blended over it
+ * with 8-bit alpha. A flash on NOTIFY never restarts the animation
+ * below it; its cost is one color blend per frame, or one byte blend
+ * per channel for per-pixel effects.
+ * 
+ * Master brightness is the last stage of that pipeline. It scales what
+ * goes into the pixel buffers but never the colors the engine keeps, so
+ * changing it rebuilds the current frame instead of rescaling the
+ * buffers like Adafruit_NeoPixel::setBrightness() does, and dimming
+ * then brightening again loses nothing.
+ * 
+ * Writes only update the pixel buffers. update() pushes them to the
+ * strips, at most once per tick and LED_MAX_FPS times a second, and only
+ * for strips whose contents actually changed. Each show() blocks
+ * interrupts, so skipping redundant ones keeps servo pulses and millis()
+ * steady. flush() pushes pending changes immediately.
+ * 
+ * With ENABLE_LED_SERVO_SYNC, each strip's show() is also held back
+ * until the Servo library's timer has no pulse edge due for longer than
+ * the show takes, so no servo pulse gets stretched. In MIRROR mode the
+ * two arms are sent in separate windows.
  */
 class LEDController {
 public:
@@ -25,8 +142,10 @@ public:
      * @param pin1 Pin for first LED strip (left arm)
      * @param pin2 Pin for second LED strip (right arm)
      * @param numPixels Number of LEDs per strip
+     * @param mode Output mode (mirror keeps a single pixel buffer)
      */
-    LEDController(uint8_t pin1, uint8_t pin2, uint8_t numPixels);
+    LEDController(uint8_t pin1, uint8_t pin2, uint16_t numPixels,
+                  LEDOutputMode mode = LEDOutputMode::MIRROR);
     
     /**
      * @brief Initialize the LED strips
@@ -37,7 +156,7 @@ public:
      * @brief Set all LEDs to a solid color
      * @param color RGB color to set
      */
-    void setColor(const RGBColor& color);
+    void setColor(RGBColor color);
     
     /**
      * @brief Set all LEDs using RGB values
@@ -47,6 +166,24 @@ public:
      */
     void setColor(uint8_t r, uint8_t g, uint8_t b);
     
+    /**
+     * @brief Set all LEDs from a hue, saturation and value
+     * @param hue Hue (0 = red, 85 = green, 170 = blue)
+     * @param saturation Saturation (0 = white, 255 = pure hue)
+     * @param value Brightness (0-255)
+     */
+    void setHSV(uint8_t hue, uint8_t saturation = 255, uint8_t value = 255);
+    
+    /**
+     * @brief Set each arm to its own color
+     * 
+     * Only differs from setColor() in INDEPENDENT mode; in MIRROR mode
+     * both arms show the left color.
+     * @param left Left arm color
+     * @param right Right arm color
+     */
+    void setArmColors(RGBColor left, RGBColor right);
+    
     /**
      * @brief Turn off all LEDs
      */
@@ -57,7 +194,7 @@ public:
      * @param color Target color
      * @param duration Duration of fade in milliseconds
      */
-    void fadeIn(const RGBColor& color, uint16_t duration = 500);
+    void fadeIn(RGBColor color, uint16_t duration = 500);
     
     /**
      * @brief Fade from current color to black
@@ -71,28 +208,232 @@ public:
      * @param to Ending color
      * @param stepDelay Delay between steps (controls speed)
      */
-    void crossfade(const RGBColor& from, const RGBColor& to, uint8_t stepDelay = 10);
+    void crossfade(RGBColor from, RGBColor to, uint8_t stepDelay = 10);
+    
+    /**
+     * @brief Play a keyframe light show
+     * @param timeline Keyframes stored in PROGMEM (see light_shows.h)
+     * @param length Number of keyframes
+     */
+    void playTimeline(const LEDKeyframe* timeline, uint8_t length);
     
     /**
      * @brief Rainbow color wheel animation
      * @param cycles Number of complete cycles
      * @param speed Delay between steps
+     * @param saturation Saturation of the wheel (0-255)
+     * @param value Brightness of the wheel (0-255)
      */
-    void rainbow(uint8_t cycles = 1, uint8_t speed = 10);
+    void rainbow(uint8_t cycles = 1, uint8_t speed = 10,
+                 uint8_t saturation = 255, uint8_t value = 255);
     
     /**
      * @brief Breathing effect (fade in/out)
      * @param color Color to breathe
      * @param cycles Number of breath cycles
      */
-    void breathe(const RGBColor& color, uint8_t cycles = 3);
+    void breathe(RGBColor color, uint8_t cycles = 3);
+    
+    // =========================================================================
+    // NON-BLOCKING ANIMATION ENGINE
+    // =========================================================================
+    
+    /**
+     * @brief Start a fade from black to a target color
+     * @param color Target color
+     * @param duration Duration of fade in milliseconds
+     */
+    void startFadeIn(RGBColor color, uint16_t duration = 500);
+    
+    /**
+     * @brief Start a fade from the current color to black
+     * @param duration Duration of fade in milliseconds
+     */
+    void startFadeOut(uint16_t duration = 500);
+    
+    /**
+     * @brief Start a transition between two colors
+     * @param from Starting color
+     * @param to Ending color
+     * @param duration Duration of transition in milliseconds
+     * @param easing Curve the transition follows
+     */
+    void startCrossfade(RGBColor from, RGBColor to, uint16_t duration,
+                        Easing easing = Easing::LINEAR);
+    
+    /**
+     * @brief Start a rainbow color wheel animation
+     * @param cycles Number of complete cycles
+     * @param speed Milliseconds per hue step
+     * @param saturation Saturation of the wheel (0-255)
+     * @param value Brightness of the wheel (0-255)
+     */
+    void startRainbow(uint8_t cycles = 1, uint8_t speed = 10,
+                      uint8_t saturation = 255, uint8_t value = 255);
+    
+    /**
+     * @brief Start a breathing effect
+     * @param color Color to breathe
+     * @param cycles Number of breath cycles
+     */
+    void startBreathe(RGBColor color, uint8_t cycles = 3);
+    
+    /**
+     * @brief Start a keyframe light show
+     * 
+     * The first keyframe fades from the color currently showing.
+     * @param timeline Keyframes stored in PROGMEM (see light_shows.h)
+     * @param length Number of keyframes
+     */
+    void startTimeline(const LEDKeyframe* timeline, uint8_t length);
+    
+    /**
+     * @brief Start a per-pixel effect
+     * 
+     * Frames are computed at the frame rate cap. Each frame's compute
+     * time is checked against LED_EFFECT_BUDGET_US.
+     * @param effect Effect to run
+     * @param params Colors, speed and level of the effect
+     * @param duration Run time in milliseconds (0 = until stopped)
+     */
+    void startEffect(LEDEffect effect, const LEDEffectParams& params, uint32_t duration = 0);
+    
+    /**
+     * @brief Change the level of the running effect (e.g. a VU_BAR input)
+     * @param level New level (0-255)
+     */
+    void setEffectLevel(uint8_t level) { _effectParams.level = level; }
+    
+    // =========================================================================
+    // LAYERS
+    // =========================================================================
+    
+    /**
+     * @brief Set the color and opacity of a layer
+     * 
+     * Setting BASE is the same as setColor(); alpha is ignored for it.
+     * @param layer Layer to change
+     * @param color Layer color
+     * @param alpha Opacity (0 = layer off)
+     */
+    void setLayer(LEDLayer layer, RGBColor color, uint8_t alpha = 255);
+    
+    /**
+     * @brief Make a layer transparent again
+     */
+    void clearLayer(LEDLayer layer) { setLayer(layer, Colors::BLACK, 0); }
+    
+    /**
+     * @brief Flash the NOTIFY layer over whatever is showing
+     * 
+     * Non-blocking; the animation underneath keeps running.
+     * @param color Flash color
+     * @param count Number of flashes
+     * @param onMs Time each flash is on
+     * @param offMs Time between flashes
+     * @param alpha Opacity of the flash
+     */
+    void flash(RGBColor color, uint8_t count = 1, uint16_t onMs = 100,
+               uint16_t offMs = 100, uint8_t alpha = 255);
+    
+    /**
+     * @brief Check whether a flash is still running
+     */
+    bool isFlashing() const { return _flashToggles > 0; }
+    
+    /**
+     * @brief Advance the running animation and push any pending frame
+     * @param now Current time from millis()
+     * @return true while an animation is still running
+     */
+    bool update(uint32_t now);
+    
+    /**
+     * @brief Push pending changes now, ignoring the frame rate cap
+     */
+    void flush();
     
     /**
-     * @brief Set individual strip brightness
+     * @brief Change the frame rate cap
+     * @param fps Maximum frames per second (0 = no cap)
+     */
+    void setMaxFps(uint8_t fps);
+    
+    /**
+     * @brief Number of frames written (setColor, animation steps...)
+     */
+    uint32_t getFramesRequested() const { return _framesRequested; }
+    
+    /**
+     * @brief Number of frames actually sent to the strips
+     */
+    uint32_t getFramesPushed() const { return _framesPushed; }
+    
+    /**
+     * @brief Number of shows sent without a servo quiet window (timeout)
+     */
+    uint16_t getServoSyncMisses() const { return _servoSyncMisses; }
+    
+    /**
+     * @brief Longest effect frame compute time since the last reset
+     */
+    uint16_t getEffectMaxUs() const { return _effectMaxUs; }
+    
+    /**
+     * @brief Number of effect frames that took longer than LED_EFFECT_BUDGET_US
+     */
+    uint16_t getEffectOverruns() const { return _effectOverruns; }
+    
+    /**
+     * @brief Reset the frame counters
+     */
+    void resetFrameStats();
+    
+    /**
+     * @brief Stop the running animation, keeping the current color
+     */
+    void stopAnimation();
+    
+    /**
+     * @brief Check whether an animation is running
+     */
+    bool isAnimating() const { return _animation != LEDAnimation::NONE; }
+    
+    /**
+     * @brief Get the running animation type
+     */
+    LEDAnimation getAnimation() const { return _animation; }
+    
+    /**
+     * @brief Register a callback fired when an animation completes
+     * @param callback Function to call, or nullptr to clear
+     */
+    void onAnimationComplete(LEDAnimationCallback callback) { _animCallback = callback; }
+    
+    /**
+     * @brief Switch between mirrored and independent strip output
+     * 
+     * INDEPENDENT allocates the second pixel buffer; MIRROR frees it.
+     * The current color is re-sent in the new mode.
+     */
+    void setOutputMode(LEDOutputMode mode);
+    
+    /**
+     * @brief Get the current output mode
+     */
+    LEDOutputMode getOutputMode() const { return _outputMode; }
+    
+    /**
+     * @brief Set the master brightness applied at output
      * @param brightness Brightness level (0-255)
      */
     void setBrightness(uint8_t brightness);
     
+    /**
+     * @brief Get the master brightness
+     */
+    uint8_t getBrightness() const { return _brightness; }
+    
     /**
      * @brief Get current color
      * @return Current RGB color
@@ -100,22 +441,170 @@ public:
     RGBColor getCurrentColor() const { return _currentColor; }
 
 private:
-    Adafruit_NeoPixel _strip1;
-    Adafruit_NeoPixel _strip2;
-    uint8_t _numPixels;
-    RGBColor _currentColor;
+    MirroredNeoPixel _strip1;       // Both arms in MIRROR mode, left arm otherwise
+    Adafruit_NeoPixel _strip2;      // Right arm in INDEPENDENT mode, empty otherwise
+    uint8_t _pin1;
+    uint8_t _pin2;
+    uint16_t _numPixels;
+    LEDOutputMode _outputMode;
+    uint8_t _brightness;            // Master brightness, applied in _fill()
+    RGBColor _currentColor;         // Left arm (or both arms in MIRROR mode)
+    RGBColor _rightColor;
+    
+    // Frame output
+    uint8_t _dirty;                 // LED_DIRTY_* bits of strips awaiting show()
+    uint16_t _frameInterval;        // Minimum ms between frames (up to 1000)
+    uint32_t _lastFrame;
+    uint32_t _framesRequested;
+    uint32_t _framesPushed;
+    uint16_t _servoSyncMisses;
+    
+#if SBOT_LED_DITHER
+    // Temporal dithering
+    RGBColor16 _fine;               // 8.8 color being dithered
+    uint8_t _ditherError[3];        // Carried fraction per channel
+    bool _dithering;
+#endif
+    
+    // Animation state
+    LEDAnimation _animation;
+    uint32_t _animStart;
+    uint32_t _animDuration;
+    RGBColor _animFrom;
+    RGBColor _animTo;
+    uint32_t _animRate;             // progressRate() of the running fade
+    Easing _animEasing;
+    uint8_t _animSpeed;
+    uint8_t _hueSaturation;         // Rainbow saturation and value
+    uint8_t _hueValue;
+    
+    // Light show state (TIMELINE)
+    const LEDKeyframe* _timeline;
+    uint8_t _timelineLength;
+    uint8_t _timelineIndex;         // Next keyframe to load
+    uint16_t _keyFadeMs;            // Fade part of the current keyframe
+    
+    // Per-pixel effect state (EFFECT)
+    LEDEffect _effect;
+    LEDEffectParams _effectParams;
+    uint16_t _effectMaxUs;
+    uint16_t _effectOverruns;
+    bool _perPixel;                 // Buffers hold an effect, not one color
+    uint32_t _effectElapsed;        // Time of the last effect frame
+    
+    // Layers above BASE, and the NOTIFY flash
+    LEDLayerState _layers[LED_OVERLAY_LAYERS];
+    uint16_t _flashToggles;         // On/off changes left (odd = on), up to 509
+    uint8_t _flashAlpha;
+    uint16_t _flashOnMs;
+    uint16_t _flashOffMs;
+    uint32_t _flashNext;
+    LEDAnimationCallback _animCallback;
+    
+    /**
+     * @brief Send the dirty pixel buffer(s) to the strips
+     */
+    void _push();
+    
+    /**
+     * @brief show() one strip inside a servo quiet window
+     */
+    void _showAligned(Adafruit_NeoPixel& strip);
+    
+    /**
+     * @brief Wait until no servo pulse edge is due for a while
+     * @param us Time needed with interrupts off
+     * @return false if the wait timed out
+     */
+    static bool _waitForServoQuiet(uint16_t us);
+    
+    /**
+     * @brief Write a color to both strips without touching the animation
+     * 
+     * Ends any dithering in progress.
+     */
+    void _show(uint8_t r, uint8_t g, uint8_t b);
+    
+    /**
+     * @brief Write a blend of two colors, dithering the fraction if enabled
+     * @param from Color at position 0
+     * @param to Color at position 0xFFFF
+     * @param position Position (0-0xFFFF)
+     */
+    void _showBlend(RGBColor from, RGBColor to, uint16_t position);
+    
+    /**
+     * @brief Fill the buffers with a color and mark changed strips dirty
+     */
+    void _write(uint8_t r, uint8_t g, uint8_t b);
+    
+#if SBOT_LED_DITHER
+    /**
+     * @brief Write the next dithered frame of _fine
+     */
+    void _ditherStep();
+    
+    /**
+     * @brief Dither one 8.8 channel down to 8 bits
+     * @param fine Channel value in 8.8 fixed point
+     * @param error Fraction carried from the previous frame
+     */
+    static uint8_t _ditherChannel(uint16_t fine, uint8_t& error);
+#endif
+    
+    /**
+     * @brief Compute the current animation frame
+     * @return true while the animation is still running
+     */
+    bool _animate(uint32_t now);
+    
+    /**
+     * @brief Compute an effect frame into the pixel buffers
+     */
+    void _renderEffect(uint32_t elapsed);
+    
+    /**
+     * @brief Fill a strip with a base color composited with the layers,
+     * at the master brightness
+     */
+    void _fill(Adafruit_NeoPixel& strip, RGBColor base);
+    
+    /**
+     * @brief Blend the overlay layers over a base color
+     */
+    RGBColor _compose(RGBColor color) const;
+    
+    /**
+     * @brief Rebuild the buffers after a layer changed
+     */
+    void _recompose();
+    
+    /**
+     * @brief Turn the NOTIFY flash on or off when due
+     */
+    void _updateFlash(uint32_t now);
+    
+    /**
+     * @brief Make the next timeline keyframe the current one
+     */
+    void _loadKeyframe();
+    
+    /**
+     * @brief Begin an animation at the current time
+     */
+    void _startAnimation(LEDAnimation animation, uint32_t duration);
     
     /**
-     * @brief Update both strips with current color
+     * @brief Run the current animation to completion (blocking wrappers)
      */
-    void _update();
+    void _runToCompletion();
     
     /**
-     * @brief Convert hue to RGB (for rainbow)
-     * @param hue Hue value (0-255)
-     * @return RGB color
+     * @brief Compare two colors
      */
-    RGBColor _wheel(uint8_t hue);
+    static bool _sameColor(RGBColor a, RGBColor b) {
+        return a.r == b.r && a.g == b.g && a.b == b.b;
+    }
 };
 
 #endif // SBOT_LED_CONTROLLER_H
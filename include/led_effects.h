@@ -0,0 +1,83 @@
+/**
+ * @file led_effects.h
+ * @brief Per-pixel LED effects computed on the fly from (index, time)
+ * @version 1.0.0
+ *
+ * Each effect is a pixel shader: a small function that returns the
+ * color of one pixel from its index and a per-frame context. The
+ * renderer streams shader output straight into a strip's pixel buffer,
+ * so an effect needs no frame buffer of its own and its cost grows
+ * linearly with the strip length. Shaders use 8.8 fixed point and
+ * table lookups only; anything that would need a division is worked
+ * out once per frame in the context. Positions are 8.8 pixels, so
+ * effects support strips of up to 255 pixels.
+ */
+
+#ifndef SBOT_LED_EFFECTS_H
+#define SBOT_LED_EFFECTS_H
+
+#include <Adafruit_NeoPixel.h>
+#include "colors.h"
+#include "color_math.h"
+
+/**
+ * @enum LEDEffect
+ * @brief Available per-pixel effects
+ */
+enum class LEDEffect : uint8_t {
+    CHASE,          // Theater chase: every 4th pixel lit, stepping along
+    COMET,          // Bright head with a fading tail, wrapping around
+    TWINKLE,        // Random pixels softly blinking
+    GRADIENT,       // Two-color gradient scrolling along the strip
+    VU_BAR,         // Bar graph of a live level, top pixel anti-aliased
+    RAINBOW         // Whole hue wheel along the strip, rotating
+};
+
+/**
+ * @brief Effect settings chosen by the caller
+ */
+struct LEDEffectParams {
+    RGBColor color;         // Foreground color
+    RGBColor background;    // Background (unlit) color
+    uint8_t speed;          // Pixels per second; TWINKLE: 64 = one blink
+                            // per second; GRADIENT: 1 = one strip length
+                            // per 65.5 s; RAINBOW: hue steps per second
+    uint8_t level;          // COMET tail length in pixels, TWINKLE share of
+                            // pixels lit (0-255), VU_BAR level (0-255),
+                            // RAINBOW brightness (colors unused)
+};
+
+/**
+ * @brief Per-frame values shared by every pixel of a shader pass
+ */
+struct PixelFrame {
+    const LEDEffectParams* params;
+    uint16_t count;         // Pixels in the strip
+    uint32_t timeMs;        // Time since the effect started
+    uint32_t phase;         // Effect-specific time base
+    uint16_t position;      // Effect-specific 8.8 position (head, bar top...)
+    uint16_t step;          // Effect-specific per-pixel increment
+};
+
+/**
+ * @brief Compute one frame of an effect into a strip's pixel buffer
+ * @param effect Effect to render
+ * @param params Effect settings
+ * @param timeMs Time since the effect started
+ * @param strip Strip whose buffer receives the frame (not shown)
+ */
+void renderEffect(LEDEffect effect, const LEDEffectParams& params,
+                  uint32_t timeMs, Adafruit_NeoPixel& strip);
+
+/**
+ * @brief Blend a solid color over every pixel of a strip
+ * 
+ * Works on the raw buffer, so the strip must be NEO_GRB. The color is
+ * scaled by the strip brightness, like setPixelColor() does.
+ * @param strip Strip whose buffer is blended in place (not shown)
+ * @param color Color laid over the pixels
+ * @param alpha Opacity (0-255)
+ */
+void blendPixels(Adafruit_NeoPixel& strip, RGBColor color, uint8_t alpha);
+
+#endif // SBOT_LED_EFFECTS_H
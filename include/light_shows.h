@@ -0,0 +1,63 @@
+/**
+ * @file light_shows.h
+ * @brief Keyframe timelines for SBot's LED light shows
+ * @version 1.0.0
+ *
+ * A light show is a PROGMEM array of keyframes played by
+ * LEDController::startTimeline(). Each keyframe fades from the previous
+ * color (or whatever is showing, for the first one) to its own color,
+ * then holds it. Times are stored in 10 ms ticks, so a keyframe costs
+ * 6 bytes of flash and no RAM. A new show is just a new array here.
+ */
+
+#ifndef SBOT_LIGHT_SHOWS_H
+#define SBOT_LIGHT_SHOWS_H
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "colors.h"
+#include "color_math.h"
+
+#define LED_TIMELINE_TICK_MS    10
+
+/**
+ * @brief One step of a light show (6 bytes)
+ */
+struct LEDKeyframe {
+    RGBColor color;         // Color at the end of the fade
+    uint8_t fadeTicks;      // Fade from the previous color (0 = jump)
+    uint8_t holdTicks;      // Time the color is held after the fade
+    Easing easing;          // Curve the fade follows
+};
+
+/**
+ * @brief Build a keyframe from times in milliseconds (max 2550 ms each)
+ */
+#define LED_KEYFRAME(color, fadeMs, holdMs, easing) \
+    { color, (fadeMs) / LED_TIMELINE_TICK_MS, (holdMs) / LED_TIMELINE_TICK_MS, easing }
+
+// =============================================================================
+// LIGHT SHOWS
+// =============================================================================
+
+// Timelines are defined once in light_shows.cpp and stored in PROGMEM
+
+/**
+ * @brief Red -> orange -> yellow flame, then back to magenta
+ */
+extern const LEDKeyframe FLAME_SEQUENCE[] PROGMEM;
+constexpr uint8_t FLAME_SEQUENCE_LENGTH = 4;
+
+/**
+ * @brief Dope state: the flame faded in from magenta, with a yellow hold
+ */
+extern const LEDKeyframe DOPE_SEQUENCE[] PROGMEM;
+constexpr uint8_t DOPE_SEQUENCE_LENGTH = 4;
+
+/**
+ * @brief Startup: the dope state flame with a longer yellow hold
+ */
+extern const LEDKeyframe STARTUP_SEQUENCE[] PROGMEM;
+constexpr uint8_t STARTUP_SEQUENCE_LENGTH = 4;
+
+#endif // SBOT_LIGHT_SHOWS_H
@@ -5,6 +5,11 @@
  * 
  * RTTTL (Ring Tone Text Transfer Language) format melodies
  * for playback through the piezo buzzer.
+ * 
+ * This file is the source for tools/rtttl_compile.py, which generates
+ * melodies_compiled.h and melodies_compiled.cpp (SONG_* note streams) on
+ * every build. Edit the melodies here; the firmware plays the compiled
+ * versions.
  */
 
 #ifndef SBOT_MELODIES_H
@@ -64,22 +69,24 @@ const char MELODY_SLEEP[] PROGMEM =
 // TONE FREQUENCIES (for simple beeps)
 // =============================================================================
 
+// Named without the NOTE_ prefix so they cannot collide with the
+// NOTE_* macros from PlayRtttl.hpp when both headers are included
 namespace Tones {
-    const uint16_t NOTE_C4  = 262;
-    const uint16_t NOTE_D4  = 294;
-    const uint16_t NOTE_E4  = 330;
-    const uint16_t NOTE_F4  = 349;
-    const uint16_t NOTE_G4  = 392;
-    const uint16_t NOTE_A4  = 440;
-    const uint16_t NOTE_B4  = 494;
-    const uint16_t NOTE_C5  = 523;
-    const uint16_t NOTE_D5  = 587;
-    const uint16_t NOTE_E5  = 659;
-    const uint16_t NOTE_F5  = 698;
-    const uint16_t NOTE_G5  = 784;
-    const uint16_t NOTE_A5  = 880;
-    const uint16_t NOTE_B5  = 988;
-    const uint16_t NOTE_C6  = 1047;
+    const uint16_t C4 = 262;
+    const uint16_t D4 = 294;
+    const uint16_t E4 = 330;
+    const uint16_t F4 = 349;
+    const uint16_t G4 = 392;
+    const uint16_t A4 = 440;
+    const uint16_t B4 = 494;
+    const uint16_t C5 = 523;
+    const uint16_t D5 = 587;
+    const uint16_t E5 = 659;
+    const uint16_t F5 = 698;
+    const uint16_t G5 = 784;
+    const uint16_t A5 = 880;
+    const uint16_t B5 = 988;
+    const uint16_t C6 = 1047;
 }
 
 #endif // SBOT_MELODIES_H
@@ -0,0 +1,43 @@
+/**
+ * @file melodies_compiled.h
+ * @brief Pre-compiled note streams for the melodies in melodies.h
+ * @version 1.0.0
+ * 
+ * GENERATED by tools/rtttl_compile.py - do not edit by hand.
+ * The note arrays are defined in melodies_compiled.cpp.
+ */
+
+#ifndef SBOT_MELODIES_COMPILED_H
+#define SBOT_MELODIES_COMPILED_H
+
+#include <PlayRtttl.hpp>
+
+// MELODY_DELLA: 62 notes, 124 bytes, 29280 ms
+extern const uint16_t SONG_DELLA_NOTES[] PROGMEM;
+constexpr RtttlSong SONG_DELLA = { SONG_DELLA_NOTES, 62, 1920, 29280UL };
+
+// MELODY_STARTUP: 4 notes, 8 bytes, 415 ms
+extern const uint16_t SONG_STARTUP_NOTES[] PROGMEM;
+constexpr RtttlSong SONG_STARTUP = { SONG_STARTUP_NOTES, 4, 1333, 415UL };
+
+// MELODY_SUCCESS: 4 notes, 8 bytes, 750 ms
+extern const uint16_t SONG_SUCCESS_NOTES[] PROGMEM;
+constexpr RtttlSong SONG_SUCCESS = { SONG_SUCCESS_NOTES, 4, 1200, 750UL };
+
+// MELODY_ERROR: 5 notes, 10 bytes, 1250 ms
+extern const uint16_t SONG_ERROR_NOTES[] PROGMEM;
+constexpr RtttlSong SONG_ERROR = { SONG_ERROR_NOTES, 5, 2000, 1250UL };
+
+// MELODY_ALERT: 7 notes, 14 bytes, 750 ms
+extern const uint16_t SONG_ALERT_NOTES[] PROGMEM;
+constexpr RtttlSong SONG_ALERT = { SONG_ALERT_NOTES, 7, 1200, 750UL };
+
+// MELODY_HAPPY: 11 notes, 22 bytes, 2621 ms
+extern const uint16_t SONG_HAPPY_NOTES[] PROGMEM;
+constexpr RtttlSong SONG_HAPPY = { SONG_HAPPY_NOTES, 11, 1500, 2621UL };
+
+// MELODY_SLEEP: 4 notes, 8 bytes, 3750 ms
+extern const uint16_t SONG_SLEEP_NOTES[] PROGMEM;
+constexpr RtttlSong SONG_SLEEP = { SONG_SLEEP_NOTES, 4, 3000, 3750UL };
+
+#endif // SBOT_MELODIES_COMPILED_H
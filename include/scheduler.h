@@ -0,0 +1,96 @@
+/**
+ * @file scheduler.h
+ * @brief Cooperative fixed-table task scheduler for SBot
+ * @version 1.0.0
+ */
+
+#ifndef SBOT_SCHEDULER_H
+#define SBOT_SCHEDULER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Task body, called with the current millis() value
+ */
+typedef void (*TaskFunction)(uint32_t now);
+
+/**
+ * @brief One entry in the static task table
+ * 
+ * Only name, run, periodMs and deadlineMs are set in the table; the
+ * remaining fields are runtime bookkeeping owned by the scheduler.
+ */
+struct Task {
+    PGM_P name;             // Task name in PROGMEM (for stats)
+    TaskFunction run;       // Task body
+    uint16_t periodMs;      // Run interval
+    uint16_t deadlineMs;    // Allowed start lateness before a miss is counted
+    
+    uint32_t nextRun;       // Next due time (millis)
+    uint32_t maxRunUs;      // Longest observed run time
+    uint16_t runs;          // Completed runs (saturating)
+    uint16_t missed;        // Runs started past their deadline (saturating)
+};
+
+/**
+ * @class Scheduler
+ * @brief Runs a fixed table of periodic tasks from loop()
+ * 
+ * Each call to run() starts every task that is due, measures how long
+ * it takes and counts deadline misses. Tasks must return quickly; a
+ * task that blocks delays every other task, which shows up in stats.
+ * 
+ * The one deliberate exception is a state (dope, chill, startup): it
+ * runs to completion inside the task that received the command, with
+ * only yield() servicing LEDs, servos and audio, and no input polled
+ * until it ends. Such a task calls markLongRun() so that run is
+ * counted apart instead of skewing every task's stats.
+ */
+class Scheduler {
+public:
+    /**
+     * @brief Construct scheduler over a task table
+     * @param tasks Task table (must outlive the scheduler)
+     * @param count Number of tasks in the table
+     */
+    Scheduler(Task* tasks, uint8_t count);
+    
+    /**
+     * @brief Reset timing and schedule every task to run now
+     */
+    void begin();
+    
+    /**
+     * @brief Run all due tasks once; call from loop()
+     */
+    void run();
+    
+    /**
+     * @brief Mark the running task as knowingly long-running
+     * 
+     * Its run time stays out of max_us, and the other tasks restart on
+     * a fresh schedule afterwards rather than each counting a miss.
+     * Has no effect outside run().
+     */
+    void markLongRun();
+    
+    /**
+     * @brief Print per-task statistics
+     * @param out Output (usually Serial)
+     */
+    void printStats(Print& out) const;
+    
+    /**
+     * @brief Clear run time and deadline statistics
+     */
+    void resetStats();
+
+private:
+    Task* _tasks;
+    uint8_t _count;
+    bool _running;          // Inside a task called from run()
+    bool _longRun;          // Running task called markLongRun()
+    uint16_t _longRuns;     // Long runs since the last reset (saturating)
+};
+
+#endif // SBOT_SCHEDULER_H
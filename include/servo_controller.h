@@ -7,21 +7,31 @@
 #ifndef SBOT_SERVO_CONTROLLER_H
 #define SBOT_SERVO_CONTROLLER_H
 
-#include <Servo.h>
+#include <MotionController.h>
+#include <TrajectoryPlanner.h>
 #include "config.h"
 
+#define ARM_CHANNELS    (MOTION_CHANNEL(ARM_CHANNEL_LEFT) | MOTION_CHANNEL(ARM_CHANNEL_RIGHT))
+
 /**
  * @class ArmController
  * @brief Controls SBot's arm servos with smooth movements
+ * 
+ * The arms are channels ARM_CHANNEL_LEFT/RIGHT of the MotionController
+ * that also drives Otto's legs, so moveTo() can run while the legs
+ * dance. Untimed moves go through a TrajectoryPlanner per arm, limited
+ * to ARM_MAX_SPEED and ARM_MAX_ACCEL. The blocking methods start a
+ * move and wait for it.
  */
 class ArmController {
 public:
     /**
      * @brief Construct arm controller with specified pins
+     * @param motion Motion controller owning the arm channels
      * @param leftPin Pin for left arm servo
      * @param rightPin Pin for right arm servo
      */
-    ArmController(uint8_t leftPin, uint8_t rightPin);
+    ArmController(MotionController& motion, uint8_t leftPin, uint8_t rightPin);
     
     /**
      * @brief Initialize and attach servos
@@ -67,11 +77,40 @@ public:
      */
     void setPosition(uint8_t leftAngle, uint8_t rightAngle);
     
+    /**
+     * @brief Queue a speed- and acceleration-limited move of both arms
+     *
+     * Doesn't wait. Moves queued back to back in the same direction
+     * blend without stopping in between.
+     * @param leftAngle Target left arm angle
+     * @param rightAngle Target right arm angle
+     * @return false if the arm queues are full
+     */
+    bool moveTo(uint8_t leftAngle, uint8_t rightAngle);
+    
+    /**
+     * @brief Start moving both arms over a fixed time without waiting
+     * @param leftAngle Target left arm angle
+     * @param rightAngle Target right arm angle
+     * @param duration Length of the move in ms
+     */
+    void moveTo(uint8_t leftAngle, uint8_t rightAngle, uint16_t duration);
+    
+    /**
+     * @brief Check whether an arm move is still running
+     */
+    bool isMoving() const { return _motion.isMoving(ARM_CHANNELS); }
+    
+    /**
+     * @brief Wait for the running arm move to finish
+     */
+    void wait() { _motion.wait(ARM_CHANNELS); }
+    
     /**
      * @brief Smoothly move arms to position
      * @param leftAngle Target left arm angle
      * @param rightAngle Target right arm angle
-     * @param speed Delay between steps (lower = faster)
+     * @param speed Milliseconds per degree at full speed (lower = faster)
      */
     void smoothMove(uint8_t leftAngle, uint8_t rightAngle, uint8_t speed = 15);
     
@@ -89,20 +128,21 @@ public:
     /**
      * @brief Get current left arm angle
      */
-    uint8_t getLeftAngle() const { return _leftAngle; }
+    uint8_t getLeftAngle() const { return _motion.read(ARM_CHANNEL_LEFT); }
     
     /**
      * @brief Get current right arm angle
      */
-    uint8_t getRightAngle() const { return _rightAngle; }
+    uint8_t getRightAngle() const { return _motion.read(ARM_CHANNEL_RIGHT); }
 
 private:
-    Servo _leftArm;
-    Servo _rightArm;
+    MotionController& _motion;
+    TrajectoryPlanner _leftPlan;
+    TrajectoryPlanner _rightPlan;
     uint8_t _leftPin;
     uint8_t _rightPin;
-    uint8_t _leftAngle;
-    uint8_t _rightAngle;
+    
+    void _setLimits(uint16_t maxSpeed);
 };
 
 #endif // SBOT_SERVO_CONTROLLER_H
@@ -8,6 +8,7 @@
 #define SBOT_STATES_H
 
 #include <stdint.h>
+#include <PlayRtttl.hpp>
 
 // Forward declarations
 class LEDController;
@@ -37,6 +38,10 @@ const char* getStateName(SBotState state);
 /**
  * @class StateManager
  * @brief Manages SBot's behavioral states
+ * 
+ * Each run*() sequence blocks until it ends; LEDs, servos and audio
+ * keep going through yield(). Called from a scheduler task, mark the
+ * run with Scheduler::markLongRun() first.
  */
 class StateManager {
 public:
@@ -82,8 +87,17 @@ public:
     
     /**
      * @brief Return to idle state
+     * 
+     * Starts the fade to the idle color without waiting for it;
+     * update() finishes it in the background.
      */
     void returnToIdle();
+    
+    /**
+     * @brief Advance background work (LED animations, melody)
+     * @param now Current time from millis()
+     */
+    void update(uint32_t now);
 
 private:
     LEDController& _leds;
@@ -91,6 +105,18 @@ private:
     uint8_t _buzzerPin;
     SBotState _currentState;
     SBotState _previousState;
+    RtttlPlayer _player;
+    
+    /**
+     * @brief Wait for the background melody to finish
+     */
+    void _waitForMelody();
+    
+    /**
+     * @brief Wait while keeping LED animations and melody running
+     * @param ms Time to wait in milliseconds
+     */
+    void _wait(uint16_t ms);
 };
 
 #endif // SBOT_STATES_H
@@ -0,0 +1,294 @@
+/**
+ * @file MotionController.cpp
+ * @brief Shared servo interpolation for Otto's legs and extra channels
+ * @version 1.0.0
+ */
+
+#include "MotionController.h"
+#include "TrajectoryPlanner.h"
+
+#if MOTION_USE_ISR
+static MotionController* isrController = NULL;
+
+ISR(TIMER0_COMPB_vect, ISR_NOBLOCK) {
+    // Interrupts stay enabled so the Servo library's pulse timer can cut
+    // in; a step that overruns the next compare is not re-entered
+    static volatile bool busy = false;
+    if (busy || isrController == NULL) return;
+    busy = true;
+    isrController->tick();
+    busy = false;
+}
+#endif
+
+MotionController::MotionController()
+    : _moving(0)
+    , _lastStep(0) {
+#if MOTION_USE_ISR
+    _commandHead = 0;
+    _commandTail = 0;
+    _interruptDriven = false;
+    _tickCount = 0;
+#endif
+    for (uint8_t i = 0; i < MOTION_CHANNELS; i++) {
+#if MOTION_USE_ISR
+        _plansQueued[i] = 0;
+        _plansTaken[i] = 0;
+#endif
+        _channels[i].trim = 0;
+        _channels[i].position = 90;
+        _channels[i].written = false;
+        _channels[i].from = 90;
+        _channels[i].target = 90;
+        _channels[i].duration = 0;
+        _channels[i].start = 0;
+        _channels[i].planner = NULL;
+    }
+}
+
+void MotionController::begin() {
+#if MOTION_USE_ISR
+    isrController = this;
+    _interruptDriven = true;
+
+    // Timer0 already runs for millis(); compare B adds an interrupt at
+    // the same 1.024 ms rate, half a period away from the overflow
+    OCR0B = 0x80;
+    TIMSK0 |= _BV(OCIE0B);
+#endif
+}
+
+void MotionController::attach(uint8_t channel, uint8_t pin) {
+    _channels[channel].servo.attach(pin);
+}
+
+void MotionController::detach(uint8_t channel) {
+    _channels[channel].servo.detach();
+}
+
+void MotionController::setTrim(uint8_t channel, int8_t trim) {
+    _submit(MotionOp::TRIM, channel, 0, (uint16_t)(int16_t)trim);
+}
+
+void MotionController::write(uint8_t channel, int angle) {
+    _submit(MotionOp::WRITE, channel, constrain(angle, 0, 180));
+}
+
+void MotionController::moveTo(uint8_t channel, int angle, uint16_t duration) {
+    if (duration == 0) {
+        write(channel, angle);
+        return;
+    }
+    _submit(MotionOp::MOVE, channel, constrain(angle, 0, 180), duration);
+}
+
+void MotionController::setPlanner(uint8_t channel, TrajectoryPlanner* planner) {
+    _channels[channel].planner = planner;
+    _resetPlanner(channel);
+}
+
+bool MotionController::planTo(uint8_t channel, int angle) {
+    if (!canPlan(channel)) return false;
+
+    _submit(MotionOp::PLAN, channel, constrain(angle, 0, 180));
+    return true;
+}
+
+bool MotionController::canPlan(uint8_t channel) const {
+    const TrajectoryPlanner* planner = _channels[channel].planner;
+    if (planner == NULL) return false;
+
+    uint8_t inFlight = 0;
+#if MOTION_USE_ISR
+    // Read the taken count before the planner: the interrupt pushes first,
+    // so a waypoint caught in between is counted twice, never missed
+    inFlight = _plansQueued[channel] - _plansTaken[channel];
+#endif
+    return planner->getQueued() + inFlight < PLANNER_WAYPOINTS;
+}
+
+void MotionController::setLimits(uint8_t channel, uint16_t maxSpeed, uint16_t maxAccel) {
+    if (_channels[channel].planner == NULL) return;
+    _submit(MotionOp::LIMITS, channel, 0, maxSpeed, maxAccel);
+}
+
+bool MotionController::update(unsigned long now) {
+#if MOTION_USE_ISR
+    // Once begin() has run, the interrupt does the stepping
+    if (_interruptDriven) return isMoving();
+#endif
+    if (_moving == 0) return false;
+
+    bool step = now - _lastStep >= MOTION_INTERVAL;
+    if (step) _lastStep = now;
+    _step(now, step);
+    return _moving != 0;
+}
+
+void MotionController::tick() {
+#if MOTION_USE_ISR
+    // Apply commands oldest first; the tail moves only once a command
+    // has taken effect, so isMoving() never sees a gap
+    uint8_t tail = _commandTail;
+    while (tail != _commandHead) {
+        const MotionCommand& command = _commands[tail];
+        _apply(command);
+        if (command.op == MotionOp::PLAN) _plansTaken[command.channel]++;
+        tail = (tail + 1) & (MOTION_COMMANDS - 1);
+        _commandTail = tail;
+    }
+
+    if (++_tickCount < MOTION_ISR_TICKS) return;
+    _tickCount = 0;
+    if (_moving != 0) _step(millis(), true);
+#endif
+}
+
+bool MotionController::isMoving(uint8_t mask) const {
+    // Queued commands first: the interrupt sets _moving before it moves
+    // the tail, so a command leaving the queue is still seen
+    uint8_t moving = _pendingMask();
+    moving |= _moving;
+    return (moving & mask) != 0;
+}
+
+void MotionController::stop(uint8_t mask) {
+    _submit(MotionOp::STOP, mask, 0);
+}
+
+void MotionController::wait(uint8_t mask) {
+    while (isMoving(mask)) {
+        update(millis());
+        delay(1);
+    }
+}
+
+void MotionController::_submit(MotionOp op, uint8_t channel, uint8_t angle,
+                               uint16_t value, uint16_t accel) {
+    MotionCommand command = { op, channel, angle, value, accel };
+
+#if MOTION_USE_ISR
+    if (_interruptDriven) {
+        uint8_t head = _commandHead;
+        uint8_t next = (head + 1) & (MOTION_COMMANDS - 1);
+        while (next == _commandTail) {
+            // Full: the interrupt empties it within a millisecond
+        }
+        _commands[head] = command;
+        if (op == MotionOp::PLAN) _plansQueued[channel]++;
+
+        // The slot must be complete before the interrupt can see it
+        __asm__ __volatile__("" ::: "memory");
+        _commandHead = next;
+        return;
+    }
+#endif
+    _apply(command);
+}
+
+#if MOTION_USE_ISR
+uint8_t MotionController::_pendingMask() const {
+    // Channels touched by commands the interrupt has not applied yet; only
+    // the foreground writes the slots, so they are safe to read here
+    uint8_t mask = 0;
+    for (uint8_t i = _commandTail; i != _commandHead; i = (i + 1) & (MOTION_COMMANDS - 1)) {
+        const MotionCommand& command = _commands[i];
+        // STOP carries a mask in its channel field
+        mask |= command.op == MotionOp::STOP ? command.channel : MOTION_CHANNEL(command.channel);
+    }
+    return mask;
+}
+#endif
+
+void MotionController::_apply(const MotionCommand& command) {
+    uint8_t channel = command.channel;
+
+    if (command.op == MotionOp::STOP) {
+        // channel is a mask here
+        _moving &= ~channel;
+        for (uint8_t i = 0; i < MOTION_CHANNELS; i++) {
+            if (channel & MOTION_CHANNEL(i)) _resetPlanner(i);
+        }
+        return;
+    }
+
+    MotionChannel& c = _channels[channel];
+    switch (command.op) {
+        case MotionOp::WRITE:
+            _moving &= ~MOTION_CHANNEL(channel);
+            _write(channel, command.angle);
+            _resetPlanner(channel);
+            break;
+
+        case MotionOp::MOVE:
+            c.from = c.position;
+            c.target = command.angle;
+            c.duration = command.value;
+            c.start = millis();
+            _resetPlanner(channel);
+            _moving |= MOTION_CHANNEL(channel);
+            break;
+
+        case MotionOp::PLAN:
+            // Start from wherever the channel is, even midway through a timed move
+            if (!c.planner->isMoving()) c.planner->reset(c.position);
+            if (c.planner->push(command.angle)) _moving |= MOTION_CHANNEL(channel);
+            break;
+
+        case MotionOp::LIMITS:
+            c.planner->setLimits(command.value, command.accel);
+            break;
+
+        case MotionOp::TRIM:
+            c.trim = (int8_t)command.value;
+            if (c.written) {
+                c.written = false;
+                _write(channel, c.position);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void MotionController::_step(unsigned long now, bool step) {
+    for (uint8_t i = 0; i < MOTION_CHANNELS; i++) {
+        if (!(_moving & MOTION_CHANNEL(i))) continue;
+        MotionChannel& c = _channels[i];
+
+        if (c.planner != NULL && c.planner->isMoving()) {
+            // Planned move: one planner tick per interpolation step
+            if (step) {
+                _write(i, c.planner->step());
+                if (!c.planner->isMoving()) _moving &= ~MOTION_CHANNEL(i);
+            }
+            continue;
+        }
+
+        unsigned long elapsed = now - c.start;
+        if (elapsed >= c.duration) {
+            // Land exactly on the target as soon as the move is due
+            _write(i, c.target);
+            _moving &= ~MOTION_CHANNEL(i);
+        } else if (step) {
+            int delta = c.target - c.from;
+            _write(i, c.from + (int)((long)delta * (long)elapsed / c.duration));
+        }
+    }
+}
+
+void MotionController::_write(uint8_t channel, uint8_t angle) {
+    MotionChannel& c = _channels[channel];
+    // The first write always goes out, even at the starting 90
+    if (c.written && angle == c.position) return;
+    c.position = angle;
+    c.written = true;
+    c.servo.write(angle + c.trim);
+}
+
+void MotionController::_resetPlanner(uint8_t channel) {
+    // Drop planned waypoints and hold at the channel's current angle
+    MotionChannel& c = _channels[channel];
+    if (c.planner != NULL) c.planner->reset(c.position);
+}
@@ -0,0 +1,253 @@
+/**
+ * @file MotionController.h
+ * @brief Shared servo interpolation for Otto's legs and extra channels
+ * @version 1.0.0
+ *
+ * One controller owns every servo of the robot. Each channel moves
+ * towards its own target over its own duration, and all of them are
+ * advanced together by update(), so legs and arms can move at the same
+ * time instead of taking turns in blocking loops. A channel can also
+ * be handed a TrajectoryPlanner, after which planTo() queues
+ * speed- and acceleration-limited moves on it.
+ *
+ * Built with MOTION_USE_ISR, the stepping moves into the Timer0
+ * compare B interrupt once begin() is called. The foreground then only
+ * posts commands into a single-producer/single-consumer ring that the
+ * interrupt drains, so a blocking call in loop() no longer stalls a
+ * move.
+ */
+
+#ifndef MOTION_CONTROLLER_H
+#define MOTION_CONTROLLER_H
+
+#include <Arduino.h>
+#include <Servo.h>
+
+class TrajectoryPlanner;
+
+// =============================================================================
+// CHANNELS
+// =============================================================================
+
+#define MOTION_CHANNELS     6   // Four Otto legs, then two free channels
+#define MOTION_INTERVAL     10  // ms between interpolation steps
+
+// Step from the Timer0 compare B interrupt instead of update(). OCR0B
+// is taken, so analogWrite() is lost on OC0B (pin 5 on the Uno, 4 on
+// the Mega).
+#ifndef MOTION_USE_ISR
+#define MOTION_USE_ISR      0
+#endif
+
+#define MOTION_ISR_TICKS    10  // Timer0 compares (1.024 ms) per step
+#define MOTION_COMMANDS     8   // Command ring slots (power of 2)
+
+// Channel masks for isMoving(), stop() and wait()
+#define MOTION_CHANNEL(n)   ((uint8_t)(1 << (n)))
+#define MOTION_LEGS         0x0F    // Channels 0-3, driven by Otto
+#define MOTION_ALL          ((uint8_t)((1 << MOTION_CHANNELS) - 1))
+
+/**
+ * @brief State of one servo channel
+ */
+struct MotionChannel {
+    Servo servo;
+    int8_t trim;            // Added to every angle written
+    uint8_t position;       // Last angle written (without trim)
+    bool written;           // position has been sent to the servo
+    uint8_t from;           // Angle at the start of the move
+    uint8_t target;         // Angle at the end of the move
+    uint16_t duration;      // Length of the move in ms
+    unsigned long start;    // millis() when the move started
+    TrajectoryPlanner* planner; // Drives planTo() moves, if set
+};
+
+/**
+ * @enum MotionOp
+ * @brief What a queued command does to its channel
+ */
+enum class MotionOp : uint8_t {
+    WRITE,          // Jump to an angle
+    MOVE,           // Timed move to an angle
+    PLAN,           // Queue a planner waypoint
+    STOP,           // Stop the channels in a mask
+    LIMITS,         // Set the planner's speed and acceleration limits
+    TRIM            // Set the trim and resend the angle
+};
+
+/**
+ * @brief One change to a channel, applied by whoever does the stepping
+ */
+struct MotionCommand {
+    MotionOp op;
+    uint8_t channel;        // Channel, or channel mask for STOP
+    uint8_t angle;
+    uint16_t value;         // MOVE: duration in ms; LIMITS: max speed;
+                            // TRIM: trim
+    uint16_t accel;         // LIMITS: max acceleration
+};
+
+// =============================================================================
+// MOTION CONTROLLER CLASS
+// =============================================================================
+
+class MotionController {
+public:
+    MotionController();
+
+    /**
+     * @brief Hand the stepping to the Timer0 interrupt
+     *
+     * Does nothing unless built with MOTION_USE_ISR. Call after the
+     * servos are attached and any planners set.
+     */
+    void begin();
+
+    /**
+     * @brief Attach a channel's servo
+     * @param channel Channel (0 to MOTION_CHANNELS - 1)
+     * @param pin Servo pin
+     */
+    void attach(uint8_t channel, uint8_t pin);
+
+    /**
+     * @brief Detach a channel's servo
+     */
+    void detach(uint8_t channel);
+
+    /**
+     * @brief Set a channel's trim
+     *
+     * A channel already written is sent its angle again with the new
+     * trim; otherwise the trim takes effect on the first write.
+     * @param channel Channel
+     * @param trim Degrees added to every angle written
+     */
+    void setTrim(uint8_t channel, int8_t trim);
+
+    /**
+     * @brief Write an angle right away, ending any move on the channel
+     * @param channel Channel
+     * @param angle Angle (0-180)
+     */
+    void write(uint8_t channel, int angle);
+
+    /**
+     * @brief Start moving a channel towards an angle
+     *
+     * The move starts from wherever the channel is now and replaces
+     * any move already running or planned on it. Non-blocking: update() does the
+     * stepping.
+     * @param channel Channel
+     * @param angle Target angle (0-180)
+     * @param duration Length of the move in ms (0 = jump)
+     */
+    void moveTo(uint8_t channel, int angle, uint16_t duration);
+
+    /**
+     * @brief Give a channel a planner for planTo() moves
+     *
+     * The planner is reset to the channel's current angle. Call before
+     * begin().
+     * @param channel Channel
+     * @param planner Planner owned by the caller (NULL to remove)
+     */
+    void setPlanner(uint8_t channel, TrajectoryPlanner* planner);
+
+    /**
+     * @brief Queue a limited-speed move on a channel with a planner
+     *
+     * Consecutive moves in the same direction are blended without
+     * stopping. Non-blocking: update() does the stepping.
+     * @param channel Channel
+     * @param angle Target angle (0-180)
+     * @return false if the channel has no planner or its queue is full
+     */
+    bool planTo(uint8_t channel, int angle);
+
+    /**
+     * @brief Check whether planTo() would accept another waypoint
+     *
+     * Counts waypoints still waiting in the command queue as well as
+     * those already in the planner.
+     * @param channel Channel
+     */
+    bool canPlan(uint8_t channel) const;
+
+    /**
+     * @brief Set the limits of a channel's planner
+     * @param channel Channel
+     * @param maxSpeed Maximum speed in degrees per second
+     * @param maxAccel Maximum acceleration in degrees per second squared
+     */
+    void setLimits(uint8_t channel, uint16_t maxSpeed, uint16_t maxAccel);
+
+    /**
+     * @brief Advance every moving channel; call periodically from loop()
+     * @param now Current time from millis()
+     * @return true while any channel is still moving
+     */
+    bool update(unsigned long now);
+
+    /**
+     * @brief Apply queued commands and step when due; called by the
+     * Timer0 interrupt, not by sketches
+     */
+    void tick();
+
+    /**
+     * @brief Check whether any of the given channels is moving
+     * @param mask Channel mask (MOTION_CHANNEL(n), MOTION_LEGS...)
+     */
+    bool isMoving(uint8_t mask = MOTION_ALL) const;
+
+    /**
+     * @brief Stop the given channels where they are
+     */
+    void stop(uint8_t mask = MOTION_ALL);
+
+    /**
+     * @brief Block until the given channels have reached their targets
+     *
+     * Keeps advancing every channel meanwhile.
+     */
+    void wait(uint8_t mask = MOTION_ALL);
+
+    /**
+     * @brief Get the last angle written to a channel
+     */
+    uint8_t read(uint8_t channel) const { return _channels[channel].position; }
+
+private:
+    MotionChannel _channels[MOTION_CHANNELS];
+    volatile uint8_t _moving;       // Bit per channel with a move running
+    unsigned long _lastStep;
+
+#if MOTION_USE_ISR
+    // Command ring: the foreground only moves the head, the interrupt
+    // only the tail
+    MotionCommand _commands[MOTION_COMMANDS];
+    volatile uint8_t _commandHead;
+    volatile uint8_t _commandTail;
+    volatile bool _interruptDriven;
+    uint8_t _tickCount;
+
+    // Waypoints queued per channel by the foreground and taken by the
+    // interrupt; the difference is still in the ring
+    uint8_t _plansQueued[MOTION_CHANNELS];
+    volatile uint8_t _plansTaken[MOTION_CHANNELS];
+
+    uint8_t _pendingMask() const;
+#else
+    uint8_t _pendingMask() const { return 0; }
+#endif
+
+    void _submit(MotionOp op, uint8_t channel, uint8_t angle,
+                 uint16_t value = 0, uint16_t accel = 0);
+    void _apply(const MotionCommand& command);
+    void _step(unsigned long now, bool step);
+    void _write(uint8_t channel, uint8_t angle);
+    void _resetPlanner(uint8_t channel);
+};
+
+#endif // MOTION_CONTROLLER_H
@@ -12,14 +12,140 @@
 // Oscillation parameters
 #define OSCILLATOR_PERIOD 50
 
-// Helper macro for degree to radian conversion
-#define DEG2RAD(deg) ((deg) * PI / 180.0)
+// Note frequency definitions
+#define NOTE_B0  31
+#define NOTE_C1  33
+#define NOTE_CS1 35
+#define NOTE_D1  37
+#define NOTE_DS1 39
+#define NOTE_E1  41
+#define NOTE_F1  44
+#define NOTE_FS1 46
+#define NOTE_G1  49
+#define NOTE_GS1 52
+#define NOTE_A1  55
+#define NOTE_AS1 58
+#define NOTE_B1  62
+#define NOTE_C2  65
+#define NOTE_CS2 69
+#define NOTE_D2  73
+#define NOTE_DS2 78
+#define NOTE_E2  82
+#define NOTE_F2  87
+#define NOTE_FS2 93
+#define NOTE_G2  98
+#define NOTE_GS2 104
+#define NOTE_A2  110
+#define NOTE_AS2 117
+#define NOTE_B2  123
+#define NOTE_C3  131
+#define NOTE_CS3 139
+#define NOTE_D3  147
+#define NOTE_DS3 156
+#define NOTE_E3  165
+#define NOTE_F3  175
+#define NOTE_FS3 185
+#define NOTE_G3  196
+#define NOTE_GS3 208
+#define NOTE_A3  220
+#define NOTE_AS3 233
+#define NOTE_B3  247
+#define NOTE_C4  262
+#define NOTE_CS4 277
+#define NOTE_D4  294
+#define NOTE_DS4 311
+#define NOTE_E4  330
+#define NOTE_F4  349
+#define NOTE_FS4 370
+#define NOTE_G4  392
+#define NOTE_GS4 415
+#define NOTE_A4  440
+#define NOTE_AS4 466
+#define NOTE_B4  494
+#define NOTE_C5  523
+#define NOTE_CS5 554
+#define NOTE_D5  587
+#define NOTE_DS5 622
+#define NOTE_E5  659
+#define NOTE_F5  698
+#define NOTE_FS5 740
+#define NOTE_G5  784
+#define NOTE_GS5 831
+#define NOTE_A5  880
+#define NOTE_AS5 932
+#define NOTE_B5  988
+#define NOTE_C6  1047
+#define NOTE_CS6 1109
+#define NOTE_D6  1175
+#define NOTE_DS6 1245
+#define NOTE_E6  1319
+#define NOTE_F6  1397
+#define NOTE_FS6 1480
+#define NOTE_G6  1568
+#define NOTE_GS6 1661
+#define NOTE_A6  1760
+#define NOTE_AS6 1865
+#define NOTE_B6  1976
+#define NOTE_C7  2093
+#define NOTE_CS7 2217
+#define NOTE_D7  2349
+#define NOTE_DS7 2489
+#define NOTE_E7  2637
+#define NOTE_F7  2794
+#define NOTE_FS7 2960
+#define NOTE_G7  3136
+#define NOTE_GS7 3322
+#define NOTE_A7  3520
+#define NOTE_AS7 3729
+#define NOTE_B7  3951
+#define NOTE_C8  4186
+#define NOTE_CS8 4435
+#define NOTE_D8  4699
+#define NOTE_DS8 4978
 
-Otto::Otto() {
-    for (int i = 0; i < 4; i++) {
-        _servo_position[i] = 90;
-        _servo_trim[i] = 0;
-    }
+// Phase is a 16-bit turn: 65536 = 360 degrees, so wraparound is free
+#define PHASE_DEG(deg) ((uint16_t)((int32_t)(deg) * 65536L / 360))
+#define PHASE_RAD(rad) ((uint16_t)(int32_t)((rad) * 65536.0 / (2 * PI)))
+
+// Quarter-wave sine table, 0-90 degrees in 65 steps, Q15 (32767 = 1.0)
+static const uint16_t SINE_QUARTER[65] PROGMEM = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+     6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767
+};
+
+/**
+ * @brief Fixed-point sine of a 16-bit phase
+ * @param phase Phase angle (65536 = one turn)
+ * @return sin(phase) in Q15
+ */
+static int16_t sin16(uint16_t phase) {
+    uint16_t x = phase & 0x3FFF;
+    if (phase & 0x4000) x = 0x4000 - x;     // 2nd/4th quadrant mirror
+    
+    uint8_t idx = x >> 8;
+    uint8_t frac = x & 0xFF;
+    uint16_t a = pgm_read_word(&SINE_QUARTER[idx]);
+    uint16_t b = (idx < 64) ? pgm_read_word(&SINE_QUARTER[idx + 1]) : a;
+    int16_t value = a + (((uint32_t)(b - a) * frac) >> 8);
+    
+    return (phase & 0x8000) ? -value : value;
+}
+
+Otto::Otto(MotionController& motion)
+    : _motion(motion)
+    , _queueHead(0)
+    , _queueCount(0)
+    , _segmentActive(false)
+    , _blend(false)
+    , _homePending(false)
+    , _patternEnd(0) {
 }
 
 void Otto::init(int LL, int RL, int LF, int RF, bool load_calibration, int Buzzer) {
@@ -34,13 +160,13 @@ void Otto::init(int LL, int RL, int LF, int RF, bool load_calibration, int Buzze
 
 void Otto::attachServos() {
     for (int i = 0; i < 4; i++) {
-        _servo[i].attach(_servo_pins[i]);
+        _motion.attach(i, _servo_pins[i]);
     }
 }
 
 void Otto::detachServos() {
     for (int i = 0; i < 4; i++) {
-        _servo[i].detach();
+        _motion.detach(i);
     }
 }
 
@@ -49,33 +175,76 @@ void Otto::home() {
     _moveServos(500, target);
 }
 
-void Otto::_moveServos(int time, int target[4]) {
-    if (time > 10) {
-        for (int i = 0; i < 4; i++) {
-            _increment[i] = (target[i] - _servo_position[i]) / (time / 10.0);
-        }
-        
-        _finalTime = millis() + time;
-        
-        while (millis() < _finalTime) {
-            _partialTime = millis() + 10;
-            
-            for (int i = 0; i < 4; i++) {
-                _servo_position[i] += _increment[i];
-                _servo[i].write(_servo_position[i] + _servo_trim[i]);
-            }
-            
-            while (millis() < _partialTime);
-        }
-    } else {
-        for (int i = 0; i < 4; i++) {
-            _servo_position[i] = target[i];
-            _servo[i].write(_servo_position[i] + _servo_trim[i]);
-        }
+// =============================================================================
+// MOTION QUEUE
+// =============================================================================
+
+bool Otto::moveTo(int target[4], int time) {
+    if (_queueCount >= OTTO_MOTION_QUEUE_SIZE) return false;
+    
+    OttoPose& pose = _queue[(_queueHead + _queueCount) % OTTO_MOTION_QUEUE_SIZE];
+    for (int i = 0; i < 4; i++) {
+        pose.target[i] = constrain(target[i], 0, 180);
+    }
+    pose.duration = time > 0 ? time : 0;
+    _queueCount++;
+    _homePending = false;
+    return true;
+}
+
+bool Otto::update(unsigned long now) {
+    _motion.update(now);
+    if (_homePending && now - _patternEnd >= OTTO_BLEND_HOLD) {
+        // No move followed the last pattern, so go home now
+        _queueHome();
     }
+    if (_queueCount == 0) return false;
     
+    if (_segmentActive) {
+        // The controller lands the legs exactly on the pose
+        if (_motion.isMoving(MOTION_LEGS)) return true;
+        _queueHead = (_queueHead + 1) % OTTO_MOTION_QUEUE_SIZE;
+        _queueCount--;
+        _segmentActive = false;
+        return _queueCount > 0;
+    }
+    
+    OttoPose& pose = _queue[_queueHead];
     for (int i = 0; i < 4; i++) {
-        _servo_position[i] = target[i];
+        _motion.moveTo(i, pose.target[i], pose.duration);
+    }
+    _segmentActive = true;
+    return true;
+}
+
+void Otto::cancel() {
+    _queueCount = 0;
+    _segmentActive = false;
+    _homePending = false;
+    _motion.stop(MOTION_LEGS);
+}
+
+void Otto::_moveServos(int time, int target[4]) {
+    _waitForMotion();
+    moveTo(target, time);
+    _waitForMotion();
+}
+
+void Otto::_enqueue(int target[4], int time) {
+    while (!moveTo(target, time)) {
+        update(millis());
+        delay(1);
+    }
+}
+
+void Otto::_queueHome() {
+    int target[4] = {90, 90, 90, 90};
+    _enqueue(target, 500);
+}
+
+void Otto::_waitForMotion() {
+    while (update(millis())) {
+        delay(1);
     }
 }
 
@@ -212,263 +381,283 @@ void Otto::sing(int soundName) {
     }
 }
 
-// Note frequency definitions
-#define NOTE_B0  31
-#define NOTE_C1  33
-#define NOTE_CS1 35
-#define NOTE_D1  37
-#define NOTE_DS1 39
-#define NOTE_E1  41
-#define NOTE_F1  44
-#define NOTE_FS1 46
-#define NOTE_G1  49
-#define NOTE_GS1 52
-#define NOTE_A1  55
-#define NOTE_AS1 58
-#define NOTE_B1  62
-#define NOTE_C2  65
-#define NOTE_CS2 69
-#define NOTE_D2  73
-#define NOTE_DS2 78
-#define NOTE_E2  82
-#define NOTE_F2  87
-#define NOTE_FS2 93
-#define NOTE_G2  98
-#define NOTE_GS2 104
-#define NOTE_A2  110
-#define NOTE_AS2 117
-#define NOTE_B2  123
-#define NOTE_C3  131
-#define NOTE_CS3 139
-#define NOTE_D3  147
-#define NOTE_DS3 156
-#define NOTE_E3  165
-#define NOTE_F3  175
-#define NOTE_FS3 185
-#define NOTE_G3  196
-#define NOTE_GS3 208
-#define NOTE_A3  220
-#define NOTE_AS3 233
-#define NOTE_B3  247
-#define NOTE_C4  262
-#define NOTE_CS4 277
-#define NOTE_D4  294
-#define NOTE_DS4 311
-#define NOTE_E4  330
-#define NOTE_F4  349
-#define NOTE_FS4 370
-#define NOTE_G4  392
-#define NOTE_GS4 415
-#define NOTE_A4  440
-#define NOTE_AS4 466
-#define NOTE_B4  494
-#define NOTE_C5  523
-#define NOTE_CS5 554
-#define NOTE_D5  587
-#define NOTE_DS5 622
-#define NOTE_E5  659
-#define NOTE_F5  698
-#define NOTE_FS5 740
-#define NOTE_G5  784
-#define NOTE_GS5 831
-#define NOTE_A5  880
-#define NOTE_AS5 932
-#define NOTE_B5  988
-#define NOTE_C6  1047
-#define NOTE_CS6 1109
-#define NOTE_D6  1175
-#define NOTE_DS6 1245
-#define NOTE_E6  1319
-#define NOTE_F6  1397
-#define NOTE_FS6 1480
-#define NOTE_G6  1568
-#define NOTE_GS6 1661
-#define NOTE_A6  1760
-#define NOTE_AS6 1865
-#define NOTE_B6  1976
-#define NOTE_C7  2093
-#define NOTE_CS7 2217
-#define NOTE_D7  2349
-#define NOTE_DS7 2489
-#define NOTE_E7  2637
-#define NOTE_F7  2794
-#define NOTE_FS7 2960
-#define NOTE_G7  3136
-#define NOTE_GS7 3322
-#define NOTE_A7  3520
-#define NOTE_AS7 3729
-#define NOTE_B7  3951
-#define NOTE_C8  4186
-#define NOTE_CS8 4435
-#define NOTE_D8  4699
-#define NOTE_DS8 4978
-
 // =============================================================================
 // GESTURES
 // =============================================================================
 
-void Otto::playGesture(int gesture) {
-    switch (gesture) {
-        case OttoHappy:
-            sing(S_happy);
-            updown(2, 500, 20);
-            break;
-
-        case OttoSuperHappy:
-            sing(S_superHappy);
-            updown(4, 300, 25);
-            break;
-
-        case OttoSad:
-            sing(S_sad);
-            int sad[4] = {110, 70, 100, 80};
-            _moveServos(700, sad);
-            delay(500);
-            home();
-            break;
-
-        case OttoSleeping:
-            for (int i = 0; i < 3; i++) {
-                sing(S_sleeping);
-                delay(1000);
-            }
-            break;
-
-        case OttoFart:
-            sing(S_fart1);
-            delay(200);
-            sing(S_fart2);
-            delay(200);
-            sing(S_fart3);
-            break;
-
-        case OttoConfused:
-            sing(S_confused);
-            swing(3, 800, 30);
-            break;
-
-        case OttoVictory:
-            swing(4, 500, 30);
-            sing(S_superHappy);
-            break;
-
-        case OttoFail:
-            sing(S_sad);
-            shakeLeg(3, 500, 1);
-            break;
+/**
+ * @brief One step of a gesture: a sound, then a move or a pause
+ */
+struct OttoStep {
+    uint8_t sound;          // Played first (OttoSilent = none)
+    uint8_t move;           // Move ID, or OttoMoveNone to pause for period
+    uint8_t cycles;         // See playMove()
+    uint16_t period;        // Move period, or pause length, in ms
+    int8_t height;
+    int8_t dir;
+};
+
+static const OttoStep GESTURE_STEPS[] PROGMEM = {
+    // OttoHappy
+    { S_happy,      OttoMoveUpDown,   2, 500,  20, 1 },
+    // OttoSuperHappy
+    { S_superHappy, OttoMoveUpDown,   4, 300,  25, 1 },
+    // OttoSad
+    { S_sad,        OttoMoveSad,      0, 700,  0,  1 },
+    { OttoSilent,   OttoMoveNone,     0, 500,  0,  1 },
+    { OttoSilent,   OttoMoveHome,     0, 500,  0,  1 },
+    // OttoSleeping
+    { S_sleeping,   OttoMoveNone,     0, 1000, 0,  1 },
+    { S_sleeping,   OttoMoveNone,     0, 1000, 0,  1 },
+    { S_sleeping,   OttoMoveNone,     0, 1000, 0,  1 },
+    // OttoFart
+    { S_fart1,      OttoMoveNone,     0, 200,  0,  1 },
+    { S_fart2,      OttoMoveNone,     0, 200,  0,  1 },
+    { S_fart3,      OttoMoveNone,     0, 0,    0,  1 },
+    // OttoConfused
+    { S_confused,   OttoMoveSwing,    3, 800,  30, 1 },
+    // OttoVictory
+    { OttoSilent,   OttoMoveSwing,    4, 500,  30, 1 },
+    { S_superHappy, OttoMoveNone,     0, 0,    0,  1 },
+    // OttoFail
+    { S_sad,        OttoMoveShakeLeg, 3, 500,  0,  1 },
+};
 
-        default:
-            break;
+/**
+ * @brief Where a gesture's steps are in GESTURE_STEPS
+ */
+struct OttoGesture {
+    uint8_t first;
+    uint8_t count;
+};
+
+// Indexed by gesture ID
+static const OttoGesture GESTURES[OTTO_GESTURE_COUNT] PROGMEM = {
+    { 0,  1 },      // OttoHappy
+    { 1,  1 },      // OttoSuperHappy
+    { 2,  3 },      // OttoSad
+    { 5,  3 },      // OttoSleeping
+    { 8,  3 },      // OttoFart
+    { 11, 1 },      // OttoConfused
+    { 0,  0 },      // OttoLove
+    { 0,  0 },      // OttoAngry
+    { 0,  0 },      // OttoFretful
+    { 0,  0 },      // OttoMagic
+    { 0,  0 },      // OttoWave
+    { 12, 2 },      // OttoVictory
+    { 14, 1 },      // OttoFail
+};
+
+bool Otto::playGesture(int gesture) {
+    if (gesture < 0 || gesture >= OTTO_GESTURE_COUNT) return false;
+    
+    OttoGesture entry;
+    memcpy_P(&entry, &GESTURES[gesture], sizeof(entry));
+    
+    for (uint8_t i = 0; i < entry.count; i++) {
+        OttoStep step;
+        memcpy_P(&step, &GESTURE_STEPS[entry.first + i], sizeof(step));
+        
+        if (step.sound != OttoSilent) sing(step.sound);
+        
+        if (step.move != OttoMoveNone) {
+            playMove(step.move, step.cycles, step.period, step.height, step.dir);
+        } else if (step.period > 0) {
+            _waitForMotion();
+            delay(step.period);
+        }
     }
+    return true;
 }
 
 // =============================================================================
 // MOVEMENTS
 // =============================================================================
 
-void Otto::_oscillate(int A[4], int O[4], int T, double phase_diff[4]) {
+/**
+ * @brief Oscillator angle: O + A * sin(phase), rounded to the nearest degree
+ */
+static int oscillatorAngle(int A, int O, uint16_t phase) {
+    int32_t swing = (int32_t)A * sin16(phase);
+    return O + (int)((swing + 0x4000) >> 15);
+}
+
+void Otto::_oscillate(int A[4], int O[4], uint16_t phase[4]) {
     for (int i = 0; i < 4; i++) {
-        _servo_position[i] = round(O[i] + A[i] * sin(phase_diff[i]));
-        _servo[i].write(_servo_position[i] + _servo_trim[i]);
+        _motion.write(i, oscillatorAngle(A[i], O[i], phase[i]));
     }
 }
 
-void Otto::_execute(int A[4], int O[4], int T, double phase_diff[4], float steps = 1.0) {
+void Otto::_execute(int A[4], int O[4], int T, uint16_t phase[4], float steps = 1.0) {
+    // Finish any queued pose first so the oscillator starts from it
+    _waitForMotion();
+    
     int cycles = (int)steps;
-    if (cycles >= 1) {
-        for (int i = 0; i < cycles; i++) {
-            for (int t = 0; t < T; t += OSCILLATOR_PERIOD) {
+    if (cycles < 1) return;
+    
+    // Per-tick phase step as a 16.16 turn, so long moves do not drift
+    uint32_t q = ((uint32_t)OSCILLATOR_PERIOD << 16) / T;
+    uint32_t r = ((uint32_t)OSCILLATOR_PERIOD << 16) % T;
+    uint32_t increment = (q << 16) + ((r << 16) / T);
+    
+    uint32_t acc[4];
+    for (int j = 0; j < 4; j++) {
+        acc[j] = (uint32_t)phase[j] << 16;
+    }
+    
+    // Chained onto the last pattern: fade from it instead of jumping
+    uint8_t blendTicks = _homePending ? OTTO_BLEND_TIME / OSCILLATOR_PERIOD : 0;
+    _homePending = false;
+    uint8_t tick = 0;
+    
+    for (int i = 0; i < cycles; i++) {
+        for (int t = 0; t < T; t += OSCILLATOR_PERIOD) {
+            for (int j = 0; j < 4; j++) {
+                acc[j] += increment;
+                phase[j] = acc[j] >> 16;
+            }
+            
+            if (tick < blendTicks) {
+                // The old pattern keeps running while it fades out
+                tick++;
+                uint16_t weight = ((uint16_t)tick << 8) / blendTicks;
                 for (int j = 0; j < 4; j++) {
-                    phase_diff[j] = (phase_diff[j]) + (2 * PI * OSCILLATOR_PERIOD / T);
+                    _lastAcc[j] += _lastIncrement;
+                    int from = oscillatorAngle(_lastA[j], _lastO[j], _lastAcc[j] >> 16);
+                    int to = oscillatorAngle(A[j], O[j], phase[j]);
+                    _motion.write(j, from + (int)(((int32_t)(to - from) * weight) >> 8));
                 }
-                _oscillate(A, O, T, phase_diff);
-                delay(OSCILLATOR_PERIOD);
+            } else {
+                _oscillate(A, O, phase);
             }
+            delay(OSCILLATOR_PERIOD);
         }
     }
+    
+    if (_blend) {
+        // Hold the last pose; the next move fades from this pattern
+        for (int j = 0; j < 4; j++) {
+            _lastA[j] = A[j];
+            _lastO[j] = O[j];
+            _lastAcc[j] = acc[j];
+        }
+        _lastIncrement = increment;
+        _homePending = true;
+        _patternEnd = millis();
+    }
 }
 
-void Otto::walk(int steps, int T, int dir) {
-    int A[4] = {30, 30, 20, 20};
-    int O[4] = {0, 0, 4, -4};
-    double phase_diff[4] = {0, 0, DEG2RAD(dir * -90), DEG2RAD(dir * -90)};
+/**
+ * @brief One move: an oscillator pattern, or a still pose
+ * 
+ * Joint j follows 90 + offset + amplitude * sin(t + phase), where
+ * amplitude and offset each add a share of the caller's height in half
+ * degrees (2 = h, 1 = h/2). A move with no amplitude at all is a pose.
+ */
+struct OttoMove {
+    int8_t amplitude[4];    // Degrees
+    int8_t amplitudeH[4];   // Half degrees per degree of height
+    int8_t offset[4];       // Degrees from 90
+    int8_t offsetH[4];      // Half degrees per degree of height
+    uint16_t phase[4];      // 65536 = one turn
+    uint8_t mirror;         // Bits 0-3: phase scales with dir, 4-7: offset does
+};
+
+// Indexed by move ID
+static const OttoMove MOVES[OTTO_MOVE_COUNT] PROGMEM = {
+    // OttoMoveHome
+    { {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0x00 },
+    // OttoMoveWalk
+    { {30, 30, 20, 20}, {0, 0, 0, 0}, {0, 0, 4, -4}, {0, 0, 0, 0},
+      {0, 0, PHASE_DEG(-90), PHASE_DEG(-90)}, 0x0C },
+    // OttoMoveTurn
+    { {30, 30, 20, 20}, {0, 0, 0, 0}, {0, 0, 4, -4}, {0, 0, 0, 0},
+      {0, 0, PHASE_DEG(90), PHASE_DEG(90)}, 0x0C },
+    // OttoMoveUpDown
+    { {0, 0, 0, 0}, {0, 0, 2, 2}, {0, 0, 0, 0}, {0, 0, 2, -2},
+      {0, 0, PHASE_DEG(-90), PHASE_DEG(90)}, 0x00 },
+    // OttoMoveSwing
+    { {0, 0, 0, 0}, {0, 0, 2, 2}, {0, 0, 0, 0}, {0, 0, 1, -1}, {0, 0, 0, 0}, 0x00 },
+    // OttoMoveMoonwalker
+    { {0, 0, 0, 0}, {0, 0, 2, 2}, {0, 0, 2, -2}, {0, 0, 1, -1},
+      {0, 0, PHASE_DEG(-90), PHASE_DEG(-90)}, 0x0C },
+    // OttoMoveCrusaito: leg phase of 90 rad (not degrees) as in upstream OttoDIYLib
+    { {25, 25, 0, 0}, {0, 0, 2, 2}, {0, 0, 4, -4}, {0, 0, 1, -1},
+      {PHASE_RAD(90), PHASE_RAD(90), PHASE_DEG(-90), PHASE_DEG(-90)}, 0x0C },
+    // OttoMoveShakeLeg
+    { {25, 25, 0, 0}, {0, 0, 0, 0}, {-15, 15, 0, 0}, {0, 0, 0, 0},
+      {PHASE_DEG(-90), PHASE_DEG(90), 0, 0}, 0x30 },
+    // OttoMoveJump
+    { {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 60, -60}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0x00 },
+    // OttoMoveSad
+    { {0, 0, 0, 0}, {0, 0, 0, 0}, {20, -20, 10, -10}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0x00 },
+};
+
+bool Otto::playMove(uint8_t move, int cycles, int T, int h, int dir) {
+    if (move >= OTTO_MOVE_COUNT) return false;
     
-    for (int i = 0; i < 4; i++) O[i] += 90;
+    OttoMove m;
+    memcpy_P(&m, &MOVES[move], sizeof(m));
     
-    _execute(A, O, T, phase_diff, steps);
-    home();
+    int A[4];
+    int O[4];
+    uint16_t phase[4];
+    bool pose = true;
+    for (int i = 0; i < 4; i++) {
+        A[i] = m.amplitude[i] + m.amplitudeH[i] * h / 2;
+        int offset = m.offset[i] + m.offsetH[i] * h / 2;
+        
+        // The table holds dir = 1; like the classic calls, other values
+        // scale the mirrored terms (phase wraps, so -1 flips it exactly)
+        if (m.mirror & (0x10 << i)) offset *= dir;
+        O[i] = 90 + offset;
+        phase[i] = m.phase[i];
+        if (m.mirror & (0x01 << i)) phase[i] = (uint16_t)(phase[i] * dir);
+        if (m.amplitude[i] != 0 || m.amplitudeH[i] != 0) pose = false;
+    }
+    
+    if (!pose) {
+        _execute(A, O, T, phase, cycles);
+        if (!_blend) _queueHome();
+    } else if (cycles == 0) {
+        _enqueue(O, T);
+    } else {
+        for (int i = 0; i < cycles; i++) {
+            _enqueue(O, T / 2);
+            _queueHome();
+        }
+    }
+    return true;
+}
+
+void Otto::walk(int steps, int T, int dir) {
+    playMove(OttoMoveWalk, steps, T, 0, dir);
 }
 
 void Otto::turn(int steps, int T, int dir) {
-    int A[4] = {30, 30, 20, 20};
-    int O[4] = {0, 0, 4, -4};
-    double phase_diff[4] = {0, 0, DEG2RAD(dir * 90), DEG2RAD(dir * 90)};
-    
-    for (int i = 0; i < 4; i++) O[i] += 90;
-    
-    _execute(A, O, T, phase_diff, steps);
-    home();
+    playMove(OttoMoveTurn, steps, T, 0, dir);
 }
 
 void Otto::updown(int steps, int T, int h) {
-    int A[4] = {0, 0, h, h};
-    int O[4] = {0, 0, h, -h};
-    double phase_diff[4] = {0, 0, DEG2RAD(-90), DEG2RAD(90)};
-    
-    for (int i = 0; i < 4; i++) O[i] += 90;
-    
-    _execute(A, O, T, phase_diff, steps);
-    home();
+    playMove(OttoMoveUpDown, steps, T, h);
 }
 
 void Otto::swing(int steps, int T, int h) {
-    int A[4] = {0, 0, h, h};
-    int O[4] = {0, 0, h / 2, -h / 2};
-    double phase_diff[4] = {0, 0, DEG2RAD(0), DEG2RAD(0)};
-    
-    for (int i = 0; i < 4; i++) O[i] += 90;
-    
-    _execute(A, O, T, phase_diff, steps);
-    home();
+    playMove(OttoMoveSwing, steps, T, h);
 }
 
 void Otto::moonwalker(int steps, int T, int h, int dir) {
-    int A[4] = {0, 0, h, h};
-    int O[4] = {0, 0, h / 2 + 2, -h / 2 - 2};
-    double phase_diff[4] = {0, 0, DEG2RAD(dir * -90), DEG2RAD(dir * -90)};
-    
-    for (int i = 0; i < 4; i++) O[i] += 90;
-    
-    _execute(A, O, T, phase_diff, steps);
-    home();
+    playMove(OttoMoveMoonwalker, steps, T, h, dir);
 }
 
 void Otto::crusaito(int steps, int T, int h, int dir) {
-    int A[4] = {25, 25, h, h};
-    int O[4] = {0, 0, h / 2 + 4, -h / 2 - 4};
-    double phase_diff[4] = {90, 90, DEG2RAD(dir * -90), DEG2RAD(dir * -90)};
-    
-    for (int i = 0; i < 4; i++) O[i] += 90;
-    
-    _execute(A, O, T, phase_diff, steps);
-    home();
+    playMove(OttoMoveCrusaito, steps, T, h, dir);
 }
 
 void Otto::shakeLeg(int steps, int T, int dir) {
-    int A[4] = {25, 25, 0, 0};
-    int O[4] = {dir * -15, dir * 15, 0, 0};
-    double phase_diff[4] = {DEG2RAD(-90), DEG2RAD(90), 0, 0};
-    
-    for (int i = 0; i < 4; i++) O[i] += 90;
-    
-    _execute(A, O, T, phase_diff, steps);
-    home();
+    playMove(OttoMoveShakeLeg, steps, T, 0, dir);
 }
 
 void Otto::jump(int steps, int T) {
-    int up[4] = {90, 90, 150, 30};
-    for (int i = 0; i < steps; i++) {
-        _moveServos(T / 2, up);
-        home();
-    }
+    playMove(OttoMoveJump, steps, T);
 }
@@ -13,7 +13,7 @@
 #define OTTO_H
 
 #include <Arduino.h>
-#include <Servo.h>
+#include "MotionController.h"
 
 // =============================================================================
 // SOUND DEFINITIONS
@@ -54,14 +54,56 @@
 #define OttoWave        10
 #define OttoVictory     11
 #define OttoFail        12
+#define OTTO_GESTURE_COUNT  13
+
+// Otto moves: oscillator patterns and still poses (records in Otto.cpp)
+#define OttoMoveHome        0
+#define OttoMoveWalk        1
+#define OttoMoveTurn        2
+#define OttoMoveUpDown      3
+#define OttoMoveSwing       4
+#define OttoMoveMoonwalker  5
+#define OttoMoveCrusaito    6
+#define OttoMoveShakeLeg    7
+#define OttoMoveJump        8
+#define OttoMoveSad         9
+#define OTTO_MOVE_COUNT     10
+
+#define OttoMoveNone    0xFF    // Gesture step that only plays a sound or pauses
+#define OttoSilent      0xFF    // Gesture step without a sound
+
+// =============================================================================
+// MOTION QUEUE
+// =============================================================================
+
+#define OTTO_MOTION_QUEUE_SIZE  4   // Max queued poses
+#define OTTO_BLEND_TIME         300 // ms of cross-fade between chained patterns
+#define OTTO_BLEND_HOLD         100 // ms without a new pattern before going home
+
+/**
+ * @brief A target pose for the four leg servos, reached over a duration
+ */
+struct OttoPose {
+    uint8_t target[4];
+    uint16_t duration;
+};
 
 // =============================================================================
 // OTTO CLASS
 // =============================================================================
 
+/**
+ * The legs are channels 0-3 of a MotionController shared with the rest
+ * of the robot. Otto queues leg poses on it and writes its oscillator
+ * steps through it; the controller does the interpolation.
+ */
 class Otto {
 public:
-    Otto();
+    /**
+     * @brief Constructor
+     * @param motion Motion controller owning the servos (legs on 0-3)
+     */
+    Otto(MotionController& motion);
     
     /**
      * @brief Initialize Otto with servo pins
@@ -85,10 +127,54 @@ public:
     void detachServos();
     
     /**
-     * @brief Move to home/neutral position
+     * @brief Move to home/neutral position (blocking)
      */
     void home();
     
+    /**
+     * @brief Queue a pose to be interpolated in the background
+     * @param target Target angles for the four servos
+     * @param time Duration of the move in ms
+     * @return false if the queue is full
+     */
+    bool moveTo(int target[4], int time);
+    
+    /**
+     * @brief Advance the motion queue; call periodically from loop()
+     * 
+     * Also advances the shared MotionController, so channels moved
+     * directly on it (the arms) keep moving from this one tick.
+     * @param now Current time from millis()
+     * @return true while poses are still queued
+     */
+    bool update(unsigned long now);
+    
+    /**
+     * @brief Check whether a queued move is in progress
+     */
+    bool isMoving() const { return _queueCount > 0; }
+    
+    /**
+     * @brief Number of poses waiting or in progress
+     */
+    uint8_t queueDepth() const { return _queueCount; }
+    
+    /**
+     * @brief Drop all queued poses, holding the current position
+     */
+    void cancel();
+    
+    /**
+     * @brief Chain oscillator moves without returning home in between
+     * 
+     * When on, a move ends on its last pose instead of queueing home.
+     * The next move cross-fades from the previous pattern over
+     * OTTO_BLEND_TIME, and home is queued by update() only once no
+     * new move has started for OTTO_BLEND_HOLD.
+     * @param enabled true to blend, false to home after every move
+     */
+    void setBlend(bool enabled) { _blend = enabled; }
+    
     /**
      * @brief Play a sound
      * @param soundName Sound ID
@@ -97,9 +183,31 @@ public:
     
     /**
      * @brief Play a gesture animation
+     * 
+     * Gestures are sequences of sounds, moves and pauses stored in
+     * flash; IDs without a sequence play nothing.
      * @param gesture Gesture ID
+     * @return false if the ID is out of range
+     */
+    bool playGesture(int gesture);
+    
+    /**
+     * @brief Play a move from the move table
+     * 
+     * Oscillator moves run for the given number of cycles, then home is
+     * queued. Poses (moves that don't oscillate) are glided to over T
+     * and held if cycles is 0, otherwise visited cycles times over T/2
+     * with a return home after each.
+     * @param move Move ID (OttoMoveWalk...)
+     * @param cycles Number of cycles
+     * @param T Period in ms
+     * @param h Height, for moves that scale with it
+     * @param dir Direction for moves that mirror with it: 1 as recorded,
+     *            -1 mirrored; the mirrored phases and offsets scale with
+     *            it, as the classic walk()/shakeLeg() dir did
+     * @return false if the ID is out of range
      */
-    void playGesture(int gesture);
+    bool playMove(uint8_t move, int cycles, int T, int h = 0, int dir = 1);
     
     /**
      * @brief Walk forward/backward
@@ -164,19 +272,39 @@ public:
      */
     void jump(int steps, int T);
 
+protected:
+    /**
+     * @brief Write one oscillator step to all four servos
+     * 
+     * Protected so the benchmark harness (bench/) can time it directly.
+     */
+    void _oscillate(int A[4], int O[4], uint16_t phase[4]);
+
 private:
-    Servo _servo[4];
+    MotionController& _motion;
     int _servo_pins[4];
-    int _servo_position[4];
-    int _servo_trim[4];
     int _buzzer_pin;
     
+    // Motion queue (ring buffer)
+    OttoPose _queue[OTTO_MOTION_QUEUE_SIZE];
+    uint8_t _queueHead;
+    uint8_t _queueCount;
+    bool _segmentActive;
+    
+    // Blend mode: the last oscillator pattern, kept to cross-fade from
+    bool _blend;
+    bool _homePending;              // Legs still on the pattern's last pose
+    unsigned long _patternEnd;
+    int _lastA[4];
+    int _lastO[4];
+    uint32_t _lastAcc[4];
+    uint32_t _lastIncrement;
+    
     void _moveServos(int time, int target[4]);
-    void _oscillate(int A[4], int O[4], int T, double phase_diff[4]);
-    void _execute(int A[4], int O[4], int T, double phase_diff[4], float steps);
-    unsigned long _finalTime;
-    unsigned long _partialTime;
-    float _increment[4];
+    void _enqueue(int target[4], int time);
+    void _queueHome();
+    void _waitForMotion();
+    void _execute(int A[4], int O[4], int T, uint16_t phase[4], float steps);
     
     // Sound generation
     void _tone(float noteFrequency, long noteDuration, int silentDuration);
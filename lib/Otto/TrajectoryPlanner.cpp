@@ -0,0 +1,158 @@
+/**
+ * @file TrajectoryPlanner.cpp
+ * @brief Velocity- and acceleration-limited motion for one servo joint
+ * @version 1.0.0
+ */
+
+#include "TrajectoryPlanner.h"
+#include "MotionController.h"
+
+// Limits used until setLimits() is called
+#define PLANNER_DEFAULT_SPEED   360     // deg/s
+#define PLANNER_DEFAULT_ACCEL   1800    // deg/s^2
+
+/**
+ * @brief Integer square root (bit by bit, no division)
+ */
+static uint16_t isqrt32(uint32_t n) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > n) bit >>= 2;
+
+    while (bit) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)root;
+}
+
+TrajectoryPlanner::TrajectoryPlanner()
+    : _position(90 << 8)
+    , _speed(0)
+    , _forward(true)
+    , _head(0)
+    , _count(0) {
+    setLimits(PLANNER_DEFAULT_SPEED, PLANNER_DEFAULT_ACCEL);
+}
+
+void TrajectoryPlanner::setLimits(uint16_t maxSpeed, uint16_t maxAccel) {
+    // Convert to per-tick units once
+    _maxSpeed = ((uint32_t)maxSpeed * 256 * MOTION_INTERVAL + 500) / 1000;
+    _maxAccel = ((uint32_t)maxAccel * 256 * MOTION_INTERVAL * MOTION_INTERVAL + 500000) / 1000000;
+    if (_maxSpeed == 0) _maxSpeed = 1;
+    if (_maxAccel == 0) _maxAccel = 1;
+}
+
+void TrajectoryPlanner::reset(uint8_t angle) {
+    _position = (uint16_t)angle << 8;
+    _speed = 0;
+    _count = 0;
+}
+
+bool TrajectoryPlanner::push(uint8_t angle) {
+    if (isFull()) return false;
+
+    _waypoints[(_head + _count) % PLANNER_WAYPOINTS] = angle > 180 ? 180 : angle;
+    _count++;
+    _plan();
+    return true;
+}
+
+uint8_t TrajectoryPlanner::step() {
+    // Waypoints the joint already sits on take no time
+    while (_count > 0 && ((uint16_t)_waypoints[_head] << 8) == _position) _pop();
+    if (_count == 0) {
+        _speed = 0;
+        return getAngle();
+    }
+
+    uint16_t target = (uint16_t)_waypoints[_head] << 8;
+    bool forward = target > _position;
+    uint16_t distance = forward ? target - _position : _position - target;
+    uint16_t run = distance + _beyond[_head];
+
+    // Speed up if allowed; a reversal first slows through zero
+    uint16_t speed;
+    if (forward == _forward) {
+        speed = _speed + _maxAccel;
+    } else {
+        speed = _speed < _maxAccel ? _maxAccel - _speed : 0;
+    }
+    if (speed > _maxSpeed) speed = _maxSpeed;
+
+    // Never faster than still lets the joint stop at the end of the run
+    uint16_t brake = _stoppingSpeed(run);
+    if (speed > brake) speed = brake;
+
+    // Only needed when the limits were lowered mid-move
+    if (forward == _forward && _speed > _maxAccel && speed < _speed - _maxAccel) {
+        speed = _speed - _maxAccel;
+        if (speed > run) speed = run;
+    }
+
+    _position = forward ? _position + speed : _position - speed;
+    _speed = speed;
+    _forward = forward;
+
+    // Pass every waypoint reached this tick, up to the end of the run
+    while (_count > 0) {
+        uint16_t point = (uint16_t)_waypoints[_head] << 8;
+        if (forward ? point > _position : point < _position) break;
+        bool runEnd = _beyond[_head] == 0;
+        _pop();
+        if (runEnd) break;
+    }
+    if (_count == 0) _speed = 0;
+    return getAngle();
+}
+
+void TrajectoryPlanner::_plan() {
+    // Backward pass: a waypoint is passed without stopping when the move
+    // after it carries on the same way, so each run of same-direction
+    // moves only has to stop at its far end
+    uint16_t remaining = 0;
+    int8_t runDir = 0;
+
+    for (int8_t k = _count - 1; k >= 0; k--) {
+        uint8_t i = (_head + k) % PLANNER_WAYPOINTS;
+        uint16_t to = (uint16_t)_waypoints[i] << 8;
+        uint16_t from = k > 0
+            ? (uint16_t)_waypoints[(i + PLANNER_WAYPOINTS - 1) % PLANNER_WAYPOINTS] << 8
+            : _position;
+        int8_t dir = to > from ? 1 : (to < from ? -1 : 0);
+
+        // A reversal after this waypoint ends the run here
+        if (dir != 0 && runDir != 0 && dir != runDir) remaining = 0;
+        _beyond[i] = remaining;
+
+        if (dir != 0) runDir = dir;
+        remaining += dir > 0 ? to - from : from - to;
+    }
+}
+
+void TrajectoryPlanner::_pop() {
+    _head = (_head + 1) % PLANNER_WAYPOINTS;
+    _count--;
+}
+
+uint16_t TrajectoryPlanner::_stoppingSpeed(uint16_t distance) const {
+    // Braking by a per tick from v = k a + r covers v + (v - a) + ... + r,
+    // which is a k (k + 1) / 2 + (k + 1) r. Find the largest such v that
+    // fits in the distance; the last move is then at most a.
+    uint16_t a = _maxAccel;
+
+    // (v + a/2)^2 = a^2/4 + 2 a d is exact at multiples of a, so it
+    // gives k; the loops only fix rounding
+    uint32_t squared = (uint32_t)a * a / 4 + 2UL * a * distance;
+    uint16_t k = (isqrt32(squared) - a / 2) / a;
+    while (k > 0 && (uint32_t)a * k * (k + 1) / 2 > distance) k--;
+    while ((uint32_t)a * (k + 1) * (k + 2) / 2 <= distance) k++;
+
+    uint16_t spare = distance - (uint32_t)a * k * (k + 1) / 2;
+    return k * a + spare / (k + 1);
+}
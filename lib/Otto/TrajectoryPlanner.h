@@ -0,0 +1,108 @@
+/**
+ * @file TrajectoryPlanner.h
+ * @brief Velocity- and acceleration-limited motion for one servo joint
+ * @version 1.0.0
+ *
+ * A trapezoidal velocity profile in fixed point: positions are 1/256
+ * degree, speeds are 1/256 degree per MOTION_INTERVAL tick and
+ * accelerations 1/256 degree per tick squared. Waypoints are queued;
+ * whenever the queue changes, a backward pass works out how far each
+ * waypoint's run of same-direction moves continues. The joint only
+ * brakes for the end of a run, so consecutive moves in the same
+ * direction blend without stopping, and a reversal comes to rest first.
+ * Per tick, speed changes by at most the acceleration limit, including
+ * through a blended waypoint and the stop at the end.
+ */
+
+#ifndef TRAJECTORY_PLANNER_H
+#define TRAJECTORY_PLANNER_H
+
+#include <Arduino.h>
+
+#define PLANNER_WAYPOINTS   4   // Queued targets per joint
+
+// =============================================================================
+// TRAJECTORY PLANNER CLASS
+// =============================================================================
+
+class TrajectoryPlanner {
+public:
+    TrajectoryPlanner();
+
+    /**
+     * @brief Set the joint's limits
+     * @param maxSpeed Maximum speed in degrees per second
+     * @param maxAccel Maximum acceleration in degrees per second squared
+     */
+    void setLimits(uint16_t maxSpeed, uint16_t maxAccel);
+
+    /**
+     * @brief Hold still at an angle, dropping any queued waypoints
+     */
+    void reset(uint8_t angle);
+
+    /**
+     * @brief Queue a waypoint
+     * @param angle Target angle (0-180)
+     * @return false if the queue is full
+     */
+    bool push(uint8_t angle);
+
+    /**
+     * @brief Advance one tick along the planned path
+     * @return Angle to write this tick
+     */
+    uint8_t step();
+
+    /**
+     * @brief Check whether waypoints are left to reach
+     */
+    bool isMoving() const { return _count > 0; }
+
+    /**
+     * @brief Check whether another waypoint fits in the queue
+     */
+    bool isFull() const { return _count >= PLANNER_WAYPOINTS; }
+
+    /**
+     * @brief Get the number of waypoints still queued
+     */
+    uint8_t getQueued() const { return _count; }
+
+    /**
+     * @brief Get the current angle, rounded to a degree
+     */
+    uint8_t getAngle() const { return (_position + 128) >> 8; }
+
+    /**
+     * @brief Get the exact current position in 1/256 degree
+     */
+    uint16_t getPosition() const { return _position; }
+    
+    /**
+     * @brief Get the current speed in 1/256 degree per tick
+     *
+     * This is how far the last step() moved, and 0 once stopped.
+     */
+    uint16_t getSpeed() const { return _speed; }
+
+private:
+    uint16_t _position;             // 1/256 degree
+    uint16_t _speed;                // 1/256 degree per tick
+    uint16_t _maxSpeed;
+    uint16_t _maxAccel;             // 1/256 degree per tick squared
+    bool _forward;                  // Direction of the last move
+
+    // Waypoint queue (ring buffer), and how far each one's run goes on
+    // past it (0 = stop there)
+    uint8_t _waypoints[PLANNER_WAYPOINTS];
+    uint16_t _beyond[PLANNER_WAYPOINTS];
+    uint8_t _head;
+    uint8_t _count;
+
+    void _plan();
+    void _pop();
+    uint16_t _stoppingSpeed(uint16_t distance) const;
+};
+
+#endif // TRAJECTORY_PLANNER_H
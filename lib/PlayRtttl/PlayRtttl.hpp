@@ -5,6 +5,15 @@
  * 
  * RTTTL (Ring Tone Text Transfer Language) is a text format
  * for storing melodies, originally used for Nokia phones.
+ * 
+ * RtttlPlayer plays a melody in the background: start it, then call
+ * update() from the main loop (or a scheduler task) and it advances
+ * one note at a time, reading the text straight from PROGMEM. The
+ * blocking play functions are built on the same player.
+ * 
+ * Melodies can also be compiled ahead of time by tools/rtttl_compile.py
+ * into packed 16-bit note records (see RtttlSong), which play without
+ * any text parsing and have their exact duration known at compile time.
  */
 
 #ifndef PLAY_RTTTL_HPP
@@ -117,144 +126,306 @@ const uint16_t NOTES[] = {
     NOTE_B4  // b
 };
 
+// =============================================================================
+// COMPILED SONGS
+// =============================================================================
+
+// Packed note record layout (must match tools/rtttl_compile.py)
+#define RTTTL_REC_NOTE(r)      ((r) & 0x0F)          // 0 = pause, 1-12 = C..B
+#define RTTTL_REC_OCTAVE(r)    (((r) >> 4) & 0x07)
+#define RTTTL_REC_DURATION(r)  (((r) >> 7) & 0x07)   // log2 of the divisor
+#define RTTTL_REC_DOTTED(r)    ((r) & 0x0400)
+
 /**
- * @brief Play RTTTL melody from PROGMEM (blocking)
- * @param pin Buzzer pin
- * @param melody RTTTL string stored in PROGMEM
+ * @brief A melody pre-compiled into packed note records
+ * 
+ * Generated as constexpr values in melodies_compiled.h, so passing one
+ * by value costs no RAM.
  */
-inline void playRtttlBlockingPGM(uint8_t pin, const char* melody) {
-    // Default values
-    uint8_t defaultDuration = 4;
-    uint8_t defaultOctave = 6;
-    uint16_t bpm = 63;
+struct RtttlSong {
+    const uint16_t* notes;  // Note records in PROGMEM
+    uint16_t length;        // Number of records
+    uint16_t wholeNote;     // Whole note duration (ms)
+    uint32_t durationMs;    // Total playing time (ms)
+};
+
+// =============================================================================
+// BACKGROUND PLAYER
+// =============================================================================
+
+/**
+ * @class RtttlPlayer
+ * @brief Non-blocking RTTTL player driven by update()
+ */
+class RtttlPlayer {
+public:
+    RtttlPlayer()
+        : _melody(nullptr)
+        , _song(nullptr)
+        , _songRemaining(0)
+        , _progmem(false)
+        , _playing(false)
+        , _pin(0)
+        , _defaultDuration(4)
+        , _defaultOctave(6)
+        , _position(0)
+        , _wholeNote(0)
+        , _noteEnd(0) {
+    }
     
-    // Skip name
-    while (pgm_read_byte(melody) != ':') melody++;
-    melody++; // Skip ':'
+    /**
+     * @brief Start playing a melody stored in PROGMEM
+     * @param pin Buzzer pin
+     * @param melody RTTTL string stored in PROGMEM
+     */
+    void startPGM(uint8_t pin, const char* melody) {
+        _start(pin, melody, true);
+    }
     
-    // Parse defaults section
-    while (pgm_read_byte(melody) != ':') {
-        char c = pgm_read_byte(melody);
-        
-        if (c == 'd' && pgm_read_byte(melody + 1) == '=') {
-            melody += 2;
-            defaultDuration = 0;
-            while (pgm_read_byte(melody) >= '0' && pgm_read_byte(melody) <= '9') {
-                defaultDuration = defaultDuration * 10 + (pgm_read_byte(melody) - '0');
-                melody++;
-            }
-        }
-        else if (c == 'o' && pgm_read_byte(melody + 1) == '=') {
-            melody += 2;
-            defaultOctave = pgm_read_byte(melody) - '0';
-            melody++;
-        }
-        else if (c == 'b' && pgm_read_byte(melody + 1) == '=') {
-            melody += 2;
-            bpm = 0;
-            while (pgm_read_byte(melody) >= '0' && pgm_read_byte(melody) <= '9') {
-                bpm = bpm * 10 + (pgm_read_byte(melody) - '0');
-                melody++;
-            }
-        }
-        else {
-            melody++;
-        }
+    /**
+     * @brief Start playing a melody stored in RAM
+     * @param pin Buzzer pin
+     * @param melody RTTTL string in RAM (must stay valid while playing)
+     */
+    void start(uint8_t pin, const char* melody) {
+        _start(pin, melody, false);
     }
-    melody++; // Skip ':'
     
-    // Calculate whole note duration in ms
-    uint32_t wholeNote = (60000UL * 4) / bpm;
+    /**
+     * @brief Start playing a pre-compiled song
+     * @param pin Buzzer pin
+     * @param song Song from melodies_compiled.h
+     */
+    void startSong(uint8_t pin, RtttlSong song) {
+        stop();
+        _pin = pin;
+        _melody = nullptr;
+        _song = song.notes;
+        _songRemaining = song.length;
+        _position = 0;
+        _wholeNote = song.wholeNote;
+        _noteEnd = millis();
+        _playing = _playNextNote();
+    }
     
-    // Parse and play notes
-    while (pgm_read_byte(melody)) {
-        uint8_t duration = 0;
-        uint8_t note = 0;
-        uint8_t octave = defaultOctave;
-        bool dotted = false;
-        
-        // Skip whitespace and commas
-        while (pgm_read_byte(melody) == ' ' || pgm_read_byte(melody) == ',') {
-            melody++;
-        }
+    /**
+     * @brief Stop playback and silence the buzzer
+     */
+    void stop() {
+        if (_playing) noTone(_pin);
+        _playing = false;
+    }
+    
+    /**
+     * @brief Check whether a melody is playing
+     */
+    bool isPlaying() const { return _playing; }
+    
+    /**
+     * @brief Index of the note currently playing (0-based)
+     */
+    uint16_t position() const { return _position > 0 ? _position - 1 : 0; }
+    
+    /**
+     * @brief Advance playback; call at least every few milliseconds
+     * @param now Current time from millis()
+     * @return true while the melody is still playing
+     */
+    bool update(uint32_t now) {
+        if (!_playing) return false;
+        if ((int32_t)(now - _noteEnd) < 0) return true;
         
-        if (!pgm_read_byte(melody)) break;
+        noTone(_pin);
         
-        // Parse duration
-        while (pgm_read_byte(melody) >= '0' && pgm_read_byte(melody) <= '9') {
-            duration = duration * 10 + (pgm_read_byte(melody) - '0');
-            melody++;
+        // Stay on the beat grid unless we fell far behind
+        if ((int32_t)(now - _noteEnd) > RTTTL_MAX_LATENESS) {
+            _noteEnd = now;
         }
-        if (duration == 0) duration = defaultDuration;
         
-        // Parse note
-        char noteChar = pgm_read_byte(melody);
-        melody++;
-        
-        switch (noteChar) {
-            case 'p': note = 0; break;
-            case 'c': note = 1; break;
-            case 'd': note = 3; break;
-            case 'e': note = 5; break;
-            case 'f': note = 6; break;
-            case 'g': note = 8; break;
-            case 'a': note = 10; break;
-            case 'b': note = 12; break;
-            default: continue;
+        if (!_playNextNote()) {
+            _playing = false;
         }
-        
-        // Check for sharp
-        if (pgm_read_byte(melody) == '#') {
-            note++;
-            melody++;
+        return _playing;
+    }
+
+private:
+    // Lateness (ms) after which the beat grid is re-anchored to now
+    static const int32_t RTTTL_MAX_LATENESS = 50;
+    
+    const char* _melody;
+    const uint16_t* _song;      // Next compiled record, or nullptr for text
+    uint16_t _songRemaining;
+    bool _progmem;
+    bool _playing;
+    uint8_t _pin;
+    uint8_t _defaultDuration;
+    uint8_t _defaultOctave;
+    uint16_t _position;
+    uint32_t _wholeNote;
+    uint32_t _noteEnd;
+    
+    char _peek() const {
+        return _progmem ? (char)pgm_read_byte(_melody) : *_melody;
+    }
+    
+    uint16_t _readNumber() {
+        uint16_t value = 0;
+        while (_peek() >= '0' && _peek() <= '9') {
+            value = value * 10 + (_peek() - '0');
+            _melody++;
         }
+        return value;
+    }
+    
+    void _start(uint8_t pin, const char* melody, bool progmem) {
+        stop();
+        _pin = pin;
+        _melody = melody;
+        _song = nullptr;
+        _progmem = progmem;
+        _position = 0;
+        _defaultDuration = 4;
+        _defaultOctave = 6;
         
-        // Check for dot
-        if (pgm_read_byte(melody) == '.') {
-            dotted = true;
-            melody++;
-        }
+        uint16_t bpm = 63;
         
-        // Parse octave
-        if (pgm_read_byte(melody) >= '0' && pgm_read_byte(melody) <= '9') {
-            octave = pgm_read_byte(melody) - '0';
-            melody++;
-        }
+        // Skip name
+        while (_peek() && _peek() != ':') _melody++;
+        if (_peek()) _melody++;
         
-        // Check for dot after octave
-        if (pgm_read_byte(melody) == '.') {
-            dotted = true;
-            melody++;
+        // Parse defaults section
+        while (_peek() && _peek() != ':') {
+            char c = _peek();
+            _melody++;
+            if (_peek() != '=') continue;
+            _melody++;
+            
+            if (c == 'd') {
+                _defaultDuration = _readNumber();
+            } else if (c == 'o') {
+                _defaultOctave = _peek() - '0';
+                _melody++;
+            } else if (c == 'b') {
+                bpm = _readNumber();
+            }
         }
+        if (_peek()) _melody++;
         
-        // Calculate note duration
-        uint32_t noteDuration = wholeNote / duration;
-        if (dotted) {
-            noteDuration += noteDuration / 2;
-        }
+        if (_defaultDuration == 0) _defaultDuration = 4;
+        if (bpm == 0) bpm = 63;
         
-        // Calculate frequency
+        // Whole note duration in ms
+        _wholeNote = (60000UL * 4) / bpm;
+        _noteEnd = millis();
+        _playing = _playNextNote();
+    }
+    
+    /**
+     * @brief Start a note, octave 0-7, note 0 = pause
+     */
+    void _playNote(uint8_t note, uint8_t octave, uint32_t noteDuration) {
         uint16_t frequency = 0;
         if (note > 0 && note <= 12) {
             frequency = NOTES[note];
             // Adjust for octave (base is octave 4)
-            if (octave > 4) {
-                frequency <<= (octave - 4);
-            } else if (octave < 4) {
-                frequency >>= (4 - octave);
-            }
+            if (octave > 4) frequency <<= (octave - 4);
+            else if (octave < 4) frequency >>= (4 - octave);
         }
         
-        // Play note
         if (frequency > 0) {
-            tone(pin, frequency, noteDuration * 0.9);
-            delay(noteDuration);
-        } else {
-            delay(noteDuration);
+            tone(_pin, frequency, noteDuration * 9 / 10);
         }
         
-        noTone(pin);
+        _noteEnd += noteDuration;
+        _position++;
     }
+    
+    /**
+     * @brief Decode the next compiled record and start it
+     * @return false at the end of the song
+     */
+    bool _playNextRecord() {
+        if (_songRemaining == 0) return false;
+        
+        uint16_t rec = pgm_read_word(_song);
+        _song++;
+        _songRemaining--;
+        
+        uint32_t noteDuration = _wholeNote >> RTTTL_REC_DURATION(rec);
+        if (RTTTL_REC_DOTTED(rec)) noteDuration += noteDuration / 2;
+        
+        _playNote(RTTTL_REC_NOTE(rec), RTTTL_REC_OCTAVE(rec), noteDuration);
+        return true;
+    }
+    
+    /**
+     * @brief Parse the next note and start it
+     * @return false at the end of the melody
+     */
+    bool _playNextNote() {
+        if (_song) return _playNextRecord();
+        
+        while (true) {
+            // Skip whitespace and commas
+            while (_peek() == ' ' || _peek() == ',') _melody++;
+            if (!_peek()) return false;
+            
+            uint8_t duration = _readNumber();
+            if (duration == 0) duration = _defaultDuration;
+            
+            uint8_t note;
+            switch (_peek()) {
+                case 'p': note = 0; break;
+                case 'c': note = 1; break;
+                case 'd': note = 3; break;
+                case 'e': note = 5; break;
+                case 'f': note = 6; break;
+                case 'g': note = 8; break;
+                case 'a': note = 10; break;
+                case 'b': note = 12; break;
+                default: _melody++; continue;
+            }
+            _melody++;
+            
+            bool dotted = false;
+            uint8_t octave = _defaultOctave;
+            
+            if (_peek() == '#') { note++; _melody++; }
+            if (_peek() == '.') { dotted = true; _melody++; }
+            if (_peek() >= '0' && _peek() <= '9') { octave = _peek() - '0'; _melody++; }
+            if (_peek() == '.') { dotted = true; _melody++; }
+            
+            uint32_t noteDuration = _wholeNote / duration;
+            if (dotted) noteDuration += noteDuration / 2;
+            
+            _playNote(note, octave, noteDuration);
+            return true;
+        }
+    }
+};
+
+// =============================================================================
+// BLOCKING PLAYBACK
+// =============================================================================
+
+/**
+ * @brief Run a player until its melody ends
+ */
+inline void playRtttlToEnd(RtttlPlayer& player) {
+    while (player.update(millis())) {
+        delay(1);
+    }
+}
+
+/**
+ * @brief Play RTTTL melody from PROGMEM (blocking)
+ * @param pin Buzzer pin
+ * @param melody RTTTL string stored in PROGMEM
+ */
+inline void playRtttlBlockingPGM(uint8_t pin, const char* melody) {
+    RtttlPlayer player;
+    player.startPGM(pin, melody);
+    playRtttlToEnd(player);
 }
 
 /**
@@ -263,93 +434,9 @@ inline void playRtttlBlockingPGM(uint8_t pin, const char* melody) {
  * @param melody RTTTL string in RAM
  */
 inline void playRtttlBlocking(uint8_t pin, const char* melody) {
-    // For RAM-based strings, we need a different implementation
-    // This is a simplified version
-    
-    uint8_t defaultDuration = 4;
-    uint8_t defaultOctave = 6;
-    uint16_t bpm = 63;
-    
-    // Skip name
-    while (*melody && *melody != ':') melody++;
-    if (*melody) melody++;
-    
-    // Parse defaults
-    while (*melody && *melody != ':') {
-        if (*melody == 'd' && *(melody + 1) == '=') {
-            melody += 2;
-            defaultDuration = atoi(melody);
-            while (*melody >= '0' && *melody <= '9') melody++;
-        }
-        else if (*melody == 'o' && *(melody + 1) == '=') {
-            melody += 2;
-            defaultOctave = *melody - '0';
-            melody++;
-        }
-        else if (*melody == 'b' && *(melody + 1) == '=') {
-            melody += 2;
-            bpm = atoi(melody);
-            while (*melody >= '0' && *melody <= '9') melody++;
-        }
-        else {
-            melody++;
-        }
-    }
-    if (*melody) melody++;
-    
-    uint32_t wholeNote = (60000UL * 4) / bpm;
-    
-    while (*melody) {
-        uint8_t duration = 0;
-        uint8_t note = 0;
-        uint8_t octave = defaultOctave;
-        bool dotted = false;
-        
-        while (*melody == ' ' || *melody == ',') melody++;
-        if (!*melody) break;
-        
-        while (*melody >= '0' && *melody <= '9') {
-            duration = duration * 10 + (*melody - '0');
-            melody++;
-        }
-        if (duration == 0) duration = defaultDuration;
-        
-        char noteChar = *melody++;
-        switch (noteChar) {
-            case 'p': note = 0; break;
-            case 'c': note = 1; break;
-            case 'd': note = 3; break;
-            case 'e': note = 5; break;
-            case 'f': note = 6; break;
-            case 'g': note = 8; break;
-            case 'a': note = 10; break;
-            case 'b': note = 12; break;
-            default: continue;
-        }
-        
-        if (*melody == '#') { note++; melody++; }
-        if (*melody == '.') { dotted = true; melody++; }
-        if (*melody >= '0' && *melody <= '9') { octave = *melody - '0'; melody++; }
-        if (*melody == '.') { dotted = true; melody++; }
-        
-        uint32_t noteDuration = wholeNote / duration;
-        if (dotted) noteDuration += noteDuration / 2;
-        
-        uint16_t frequency = 0;
-        if (note > 0 && note <= 12) {
-            frequency = NOTES[note];
-            if (octave > 4) frequency <<= (octave - 4);
-            else if (octave < 4) frequency >>= (4 - octave);
-        }
-        
-        if (frequency > 0) {
-            tone(pin, frequency, noteDuration * 0.9);
-            delay(noteDuration);
-        } else {
-            delay(noteDuration);
-        }
-        noTone(pin);
-    }
+    RtttlPlayer player;
+    player.start(pin, melody);
+    playRtttlToEnd(player);
 }
 
 #endif // PLAY_RTTTL_HPP
@@ -0,0 +1,62 @@
+/**
+ * @file Adafruit_NeoPixel.h
+ * @brief Host-native NeoPixel shim that records every show()
+ * @version 1.0.0
+ *
+ * Mirrors the subset of the Adafruit API used by SBot, including the
+ * lossy setBrightness() rescale and the 300 us latch wait in show(), so
+ * output and timing match the real library.
+ */
+
+#ifndef SBOT_SIM_ADAFRUIT_NEOPIXEL_H
+#define SBOT_SIM_ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+
+#define NEO_GRB     ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_RGB     ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_KHZ800  0x0000
+
+typedef uint16_t neoPixelType;
+
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, neoPixelType type = NEO_GRB + NEO_KHZ800);
+    Adafruit_NeoPixel();
+    ~Adafruit_NeoPixel();
+
+    void begin();
+    void show();
+    void setPin(int16_t pin);
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+    void setPixelColor(uint16_t n, uint32_t c);
+    void fill(uint32_t c = 0, uint16_t first = 0, uint16_t count = 0);
+    void setBrightness(uint8_t b);
+    void clear();
+    void updateLength(uint16_t n);
+    void updateType(neoPixelType t) { (void)t; }
+    bool canShow();
+
+    uint8_t* getPixels() const { return _pixels; }
+    uint8_t getBrightness() const { return _brightness - 1; }
+    int16_t getPin() const { return _pin; }
+    uint16_t numPixels() const { return _numLEDs; }
+    uint32_t getPixelColor(uint16_t n) const;
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+protected:
+    uint32_t endTime;       // Same name as the real library: end of last show()
+
+private:
+    bool _begun;
+    uint16_t _numLEDs;
+    uint16_t _numBytes;
+    int16_t _pin;
+    uint8_t _brightness;
+    uint8_t* _pixels;
+};
+
+#endif // SBOT_SIM_ADAFRUIT_NEOPIXEL_H
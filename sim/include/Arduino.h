@@ -0,0 +1,212 @@
+/**
+ * @file Arduino.h
+ * @brief Host-native Arduino core shim for the SBot simulation build
+ * @version 1.0.0
+ *
+ * Provides just enough of the Arduino AVR core for src/ and lib/ to
+ * compile and run on Linux. Time is virtual: delay() advances the
+ * simulated clock instantly, so sequences run far faster than real time.
+ * Every hardware call is recorded through sim_trace.h.
+ */
+
+#ifndef SBOT_SIM_ARDUINO_H
+#define SBOT_SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <avr/pgmspace.h>
+
+// =============================================================================
+// TYPES AND CONSTANTS
+// =============================================================================
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH    0x1
+#define LOW     0x0
+
+#define INPUT         0x0
+#define OUTPUT        0x1
+#define INPUT_PULLUP  0x2
+
+#ifndef PI
+#define PI          3.1415926535897932384626433832795
+#endif
+#define HALF_PI     1.5707963267948966192313216916398
+#define TWO_PI      6.283185307179586476925286766559
+#define DEG_TO_RAD  0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+
+// Constants rather than macros, as in the AVR core's pins_arduino.h
+static const uint8_t A0 = 14;
+static const uint8_t A1 = 15;
+static const uint8_t A2 = 16;
+static const uint8_t A3 = 17;
+static const uint8_t A4 = 18;
+static const uint8_t A5 = 19;
+static const uint8_t A6 = 20;
+static const uint8_t A7 = 21;
+
+#define NUM_DIGITAL_PINS  22
+
+// =============================================================================
+// MATH HELPERS (macro forms match the AVR core)
+// =============================================================================
+
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define sq(x) ((x) * (x))
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// =============================================================================
+// TIME (virtual clock)
+// =============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// =============================================================================
+// I/O
+// =============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+// Interrupt control is a no-op on the host
+#define cli()
+#define sei()
+#define noInterrupts()
+#define interrupts()
+
+// =============================================================================
+// SERVO TIMER (read-only model of the Servo library's Timer1)
+// =============================================================================
+
+#define F_CPU   16000000UL
+#define _BV(bit) (1 << (bit))
+
+namespace sim {
+uint16_t servoTimerCount();
+uint16_t servoTimerCompare();
+bool servoTimerRunning();
+}
+
+#define OCIE1A  1
+#define TCNT1   (sim::servoTimerCount())
+#define OCR1A   (sim::servoTimerCompare())
+#define TIMSK1  (sim::servoTimerRunning() ? _BV(OCIE1A) : 0)
+
+// =============================================================================
+// TIMER0 COMPARE B (fires every 1024 us, on the timer behind millis())
+// =============================================================================
+
+namespace sim {
+extern uint8_t timer0Mask;
+extern uint8_t timer0CompareB;
+}
+
+#define OCIE0B  2
+#define TIMSK0  (sim::timer0Mask)
+#define OCR0B   (sim::timer0CompareB)
+
+// ISR(TIMER0_COMPB_vect) defines the handler the virtual clock calls
+#define ISR_NOBLOCK
+#define TIMER0_COMPB_vect   sim_timer0_compb_vect
+#define ISR(vector, ...)    extern "C" void vector(void); extern "C" void vector(void)
+
+// =============================================================================
+// FLASH STRINGS
+// =============================================================================
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(PSTR(string_literal)))
+
+// =============================================================================
+// PRINT / STREAM / SERIAL
+// =============================================================================
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+
+    size_t write(const char* str);
+    size_t write(const uint8_t* buffer, size_t size);
+
+    size_t print(const __FlashStringHelper* str);
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(unsigned char n, int base = DEC);
+    size_t print(int n, int base = DEC);
+    size_t print(unsigned int n, int base = DEC);
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println();
+    template <typename T>
+    size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+private:
+    size_t _printNumber(unsigned long n, uint8_t base);
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud);
+    void end() {}
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    using Print::write;
+    void flush() {}
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// =============================================================================
+// SKETCH ENTRY POINTS
+// =============================================================================
+
+void setup();
+void loop();
+
+#endif // SBOT_SIM_ARDUINO_H
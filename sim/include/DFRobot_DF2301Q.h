@@ -0,0 +1,28 @@
+/**
+ * @file DFRobot_DF2301Q.h
+ * @brief Host-native voice module shim fed from scripted command IDs
+ * @version 1.0.0
+ */
+
+#ifndef SBOT_SIM_DFROBOT_DF2301Q_H
+#define SBOT_SIM_DFROBOT_DF2301Q_H
+
+#include <Arduino.h>
+
+class DFRobot_DF2301Q_I2C {
+public:
+    DFRobot_DF2301Q_I2C(uint8_t address = 0x64) : _wakeTime(0) { (void)address; }
+
+    bool begin();
+    uint8_t getCMDID();
+    void playByCMDID(uint8_t cmdId);
+    uint8_t getWakeTime() { return _wakeTime; }
+    void setWakeTime(uint8_t wakeTime) { _wakeTime = wakeTime; }
+    void setVolume(uint8_t volume) { (void)volume; }
+    void setMuteMode(uint8_t mode) { (void)mode; }
+
+private:
+    uint8_t _wakeTime;
+};
+
+#endif // SBOT_SIM_DFROBOT_DF2301Q_H
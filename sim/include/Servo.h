@@ -0,0 +1,38 @@
+/**
+ * @file Servo.h
+ * @brief Host-native Servo shim that records every write
+ * @version 1.0.0
+ */
+
+#ifndef SBOT_SIM_SERVO_H
+#define SBOT_SIM_SERVO_H
+
+#include <Arduino.h>
+
+#define MIN_PULSE_WIDTH       544
+#define MAX_PULSE_WIDTH       2400
+#define DEFAULT_PULSE_WIDTH   1500
+#define REFRESH_INTERVAL      20000
+
+class Servo {
+public:
+    Servo();
+
+    uint8_t attach(int pin);
+    uint8_t attach(int pin, int min, int max);
+    void detach();
+    void write(int value);
+    void writeMicroseconds(int value);
+    int read();
+    int readMicroseconds();
+    bool attached();
+
+private:
+    int8_t _channel;    // Slot in the timer frame (construction order)
+    int8_t _pin;
+    int _angle;
+    int _min;
+    int _max;
+};
+
+#endif // SBOT_SIM_SERVO_H
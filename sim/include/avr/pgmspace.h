@@ -0,0 +1,31 @@
+/**
+ * @file pgmspace.h
+ * @brief Host-native stand-in for avr/pgmspace.h
+ * @version 1.0.0
+ *
+ * Flash and RAM share one address space on the host, so PROGMEM is
+ * empty and the pgm_read_* accessors are plain loads.
+ */
+
+#ifndef SBOT_SIM_PGMSPACE_H
+#define SBOT_SIM_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)  (*reinterpret_cast<const uint8_t*>(addr))
+#define pgm_read_word(addr)  (*reinterpret_cast<const uint16_t*>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t*>(addr))
+#define pgm_read_ptr(addr)   (*reinterpret_cast<void* const*>(addr))
+
+#define memcpy_P  memcpy
+#define strcmp_P  strcmp
+#define strncmp_P strncmp
+#define strlen_P  strlen
+#define strcpy_P  strcpy
+
+#endif // SBOT_SIM_PGMSPACE_H
@@ -0,0 +1,132 @@
+/**
+ * @file sim_trace.h
+ * @brief Virtual clock and hardware call recorder for the native build
+ * @version 1.0.0
+ *
+ * Every shimmed hardware call (servo write, pixel show, tone, pin I/O)
+ * is appended to an in-memory trace stamped with the virtual time, so a
+ * run can be inspected or profiled after the fact.
+ */
+
+#ifndef SBOT_SIM_TRACE_H
+#define SBOT_SIM_TRACE_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace sim {
+
+/**
+ * @enum Event
+ * @brief Kinds of hardware call recorded in the trace
+ */
+enum class Event : uint8_t {
+    PIN_MODE,
+    DIGITAL_WRITE,
+    ANALOG_READ,
+    TONE,
+    NO_TONE,
+    SERVO_ATTACH,
+    SERVO_DETACH,
+    SERVO_WRITE,
+    SERVO_JITTER,       // A servo pulse stretched by an interrupts-off span
+    PIXEL_SHOW,
+    VOICE_CMD,
+    SERIAL_LINE,
+    COUNT
+};
+
+/**
+ * @brief One recorded hardware call
+ */
+struct TraceRecord {
+    uint64_t timeUs;    // Virtual timestamp
+    Event event;
+    int16_t pin;
+    int32_t value;      // Angle, frequency, pixel checksum...
+};
+
+/**
+ * @brief Get the name of an event kind (for reports)
+ */
+const char* eventName(Event event);
+
+/**
+ * @brief Current virtual time in microseconds
+ */
+uint64_t nowUs();
+
+/**
+ * @brief Advance the virtual clock
+ * @param us Microseconds to advance
+ */
+void advanceUs(uint64_t us);
+
+/**
+ * @brief Append a record to the trace
+ */
+void record(Event event, int pin, long value);
+
+/**
+ * @brief Access the full trace
+ */
+const std::vector<TraceRecord>& trace();
+
+/**
+ * @brief Number of records of one kind
+ */
+uint32_t count(Event event);
+
+/**
+ * @brief Account for a span with interrupts disabled
+ *
+ * Any servo pulse whose end falls inside the span is stretched until
+ * interrupts come back on; each one is recorded as a SERVO_JITTER event
+ * with the error in microseconds.
+ */
+void interruptsBlocked(uint64_t startUs, uint64_t endUs);
+
+/**
+ * @brief Mask or unmask the simulated Timer0 interrupt
+ *
+ * A compare that comes due while masked is latched and runs as soon as
+ * interrupts are enabled again, as on the AVR.
+ */
+void setInterruptsEnabled(bool enabled);
+
+/**
+ * @brief Make the foreground block without yielding at regular intervals
+ *
+ * Models slow blocking work (a long Serial dump, a bus transaction):
+ * every everyMs the foreground loses lengthMs in which only interrupts
+ * run.
+ */
+void setForegroundStall(uint32_t everyMs, uint32_t lengthMs);
+
+/**
+ * @brief Schedule a line of serial input
+ * @param atMs Virtual time the line arrives
+ * @param line Text without the trailing newline
+ */
+void queueSerialInput(uint32_t atMs, const char* line);
+
+/**
+ * @brief Schedule a voice module command ID
+ * @param atMs Virtual time the command is recognised
+ * @param cmdId DF2301Q command ID
+ */
+void queueVoiceCommand(uint32_t atMs, uint8_t cmdId);
+
+/**
+ * @brief Set the value returned by analogRead() for a pin
+ */
+void setAnalogValue(uint8_t pin, int value);
+
+/**
+ * @brief Silence or restore echo of Serial output to stdout
+ */
+void setSerialEcho(bool echo);
+
+} // namespace sim
+
+#endif // SBOT_SIM_TRACE_H
@@ -0,0 +1,404 @@
+/**
+ * @file sim_core.cpp
+ * @brief Virtual clock, trace recorder and Arduino core shim
+ * @version 1.0.0
+ */
+
+#include <stdio.h>
+#include <deque>
+#include <string>
+
+#include "sim_trace.h"
+#include <Arduino.h>
+
+// Virtual cost of reading the clock, so busy-wait loops still progress
+#define SIM_CLOCK_READ_COST_US  1
+
+// Timer0 overflows every 1024 us (clk/64, 256 counts), so each compare
+// match comes round at the same rate
+#define SIM_TIMER0_PERIOD_US    1024
+
+// Weak default so programs without a Timer0 handler still link
+extern "C" __attribute__((weak)) void sim_timer0_compb_vect(void) {
+}
+
+namespace sim {
+
+uint8_t timer0Mask = 0;
+uint8_t timer0CompareB = 0;
+
+namespace {
+
+struct PendingLine {
+    uint64_t atUs;
+    std::string text;
+};
+
+struct PendingVoice {
+    uint64_t atUs;
+    uint8_t cmdId;
+};
+
+uint64_t g_nowUs = 0;
+std::vector<TraceRecord> g_trace;
+uint32_t g_counts[(uint8_t)Event::COUNT] = {0};
+std::deque<PendingLine> g_serialLines;
+std::deque<PendingVoice> g_voiceCmds;
+std::string g_serialRx;
+int g_analog[NUM_DIGITAL_PINS] = {0};
+bool g_serialEcho = true;
+
+bool g_interruptsEnabled = true;
+bool g_inInterrupt = false;
+bool g_timer0Pending = false;
+uint64_t g_stallEveryUs = 0;
+uint64_t g_stallLengthUs = 0;
+uint64_t g_nextStallUs = 0;
+
+/**
+ * @brief Move any serial lines that have "arrived" into the RX buffer
+ */
+void pumpSerial() {
+    while (!g_serialLines.empty() && g_serialLines.front().atUs <= g_nowUs) {
+        g_serialRx += g_serialLines.front().text;
+        g_serialRx += '\n';
+        record(Event::SERIAL_LINE, 0, (long)g_serialLines.front().text.size());
+        g_serialLines.pop_front();
+    }
+}
+
+/**
+ * @brief Run the Timer0 compare handler; it never nests
+ */
+void runTimer0() {
+    g_inInterrupt = true;
+    sim_timer0_compb_vect();
+    g_inInterrupt = false;
+}
+
+} // namespace
+
+const char* eventName(Event event) {
+    switch (event) {
+        case Event::PIN_MODE:      return "pin_mode";
+        case Event::DIGITAL_WRITE: return "digital_write";
+        case Event::ANALOG_READ:   return "analog_read";
+        case Event::TONE:          return "tone";
+        case Event::NO_TONE:       return "no_tone";
+        case Event::SERVO_ATTACH:  return "servo_attach";
+        case Event::SERVO_DETACH:  return "servo_detach";
+        case Event::SERVO_WRITE:   return "servo_write";
+        case Event::SERVO_JITTER:  return "servo_jitter";
+        case Event::PIXEL_SHOW:    return "pixel_show";
+        case Event::VOICE_CMD:     return "voice_cmd";
+        case Event::SERIAL_LINE:   return "serial_line";
+        default:                   return "unknown";
+    }
+}
+
+uint64_t nowUs() {
+    return g_nowUs;
+}
+
+void advanceUs(uint64_t us) {
+    uint64_t end = g_nowUs + us;
+
+    if (!g_inInterrupt) {
+        // A stall is foreground time spent without yielding
+        if (g_stallEveryUs > 0 && end >= g_nextStallUs) {
+            end += g_stallLengthUs;
+            g_nextStallUs += g_stallEveryUs;
+        }
+
+        // Fire every compare match passed on the way; time read inside
+        // the handler is not charged to the foreground
+        if (timer0Mask & _BV(OCIE0B)) {
+            uint64_t next = (g_nowUs / SIM_TIMER0_PERIOD_US + 1) * SIM_TIMER0_PERIOD_US;
+            for (; next <= end; next += SIM_TIMER0_PERIOD_US) {
+                if (g_nowUs < next) g_nowUs = next;
+                if (g_interruptsEnabled) {
+                    runTimer0();
+                } else {
+                    g_timer0Pending = true;
+                }
+            }
+        }
+    }
+    if (g_nowUs < end) g_nowUs = end;
+}
+
+void record(Event event, int pin, long value) {
+    TraceRecord rec = { g_nowUs, event, (int16_t)pin, (int32_t)value };
+    g_trace.push_back(rec);
+    g_counts[(uint8_t)event]++;
+}
+
+const std::vector<TraceRecord>& trace() {
+    return g_trace;
+}
+
+uint32_t count(Event event) {
+    return g_counts[(uint8_t)event];
+}
+
+void setInterruptsEnabled(bool enabled) {
+    g_interruptsEnabled = enabled;
+    if (enabled && g_timer0Pending && !g_inInterrupt) {
+        g_timer0Pending = false;
+        runTimer0();
+    }
+}
+
+void setForegroundStall(uint32_t everyMs, uint32_t lengthMs) {
+    g_stallEveryUs = (uint64_t)everyMs * 1000;
+    g_stallLengthUs = (uint64_t)lengthMs * 1000;
+    g_nextStallUs = g_nowUs + g_stallEveryUs;
+}
+
+void queueSerialInput(uint32_t atMs, const char* line) {
+    PendingLine pending = { (uint64_t)atMs * 1000, line };
+    g_serialLines.push_back(pending);
+}
+
+void queueVoiceCommand(uint32_t atMs, uint8_t cmdId) {
+    PendingVoice pending = { (uint64_t)atMs * 1000, cmdId };
+    g_voiceCmds.push_back(pending);
+}
+
+uint8_t takeVoiceCommand() {
+    if (g_voiceCmds.empty() || g_voiceCmds.front().atUs > g_nowUs) {
+        return 0;
+    }
+    uint8_t cmdId = g_voiceCmds.front().cmdId;
+    g_voiceCmds.pop_front();
+    record(Event::VOICE_CMD, 0, cmdId);
+    return cmdId;
+}
+
+void setAnalogValue(uint8_t pin, int value) {
+    if (pin < NUM_DIGITAL_PINS) g_analog[pin] = value;
+}
+
+void setSerialEcho(bool echo) {
+    g_serialEcho = echo;
+}
+
+int serialAvailable() {
+    pumpSerial();
+    return (int)g_serialRx.size();
+}
+
+int serialRead() {
+    pumpSerial();
+    if (g_serialRx.empty()) return -1;
+    int c = (uint8_t)g_serialRx[0];
+    g_serialRx.erase(0, 1);
+    return c;
+}
+
+int serialPeek() {
+    pumpSerial();
+    return g_serialRx.empty() ? -1 : (uint8_t)g_serialRx[0];
+}
+
+void serialWrite(uint8_t c) {
+    if (g_serialEcho) fputc(c, stdout);
+}
+
+} // namespace sim
+
+// =============================================================================
+// TIME
+// =============================================================================
+
+unsigned long millis() {
+    sim::advanceUs(SIM_CLOCK_READ_COST_US);
+    return (unsigned long)(sim::nowUs() / 1000);
+}
+
+unsigned long micros() {
+    sim::advanceUs(SIM_CLOCK_READ_COST_US);
+    return (unsigned long)sim::nowUs();
+}
+
+void delay(unsigned long ms) {
+    // Like the AVR core, keep calling yield() while waiting
+    uint64_t end = sim::nowUs() + (uint64_t)ms * 1000;
+    while (sim::nowUs() < end) {
+        yield();
+        uint64_t step = end - sim::nowUs();
+        sim::advanceUs(step < 1000 ? step : 1000);
+    }
+}
+
+void delayMicroseconds(unsigned int us) {
+    sim::advanceUs(us);
+}
+
+__attribute__((weak)) void yield() {
+}
+
+// =============================================================================
+// I/O
+// =============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    sim::record(sim::Event::PIN_MODE, pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    sim::record(sim::Event::DIGITAL_WRITE, pin, val);
+}
+
+int digitalRead(uint8_t pin) {
+    (void)pin;
+    return LOW;
+}
+
+int analogRead(uint8_t pin) {
+    int value = (pin < NUM_DIGITAL_PINS) ? sim::g_analog[pin] : 0;
+    sim::record(sim::Event::ANALOG_READ, pin, value);
+    return value;
+}
+
+void analogWrite(uint8_t pin, int val) {
+    sim::record(sim::Event::DIGITAL_WRITE, pin, val);
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+    (void)duration;
+    sim::record(sim::Event::TONE, pin, frequency);
+}
+
+void noTone(uint8_t pin) {
+    sim::record(sim::Event::NO_TONE, pin, 0);
+}
+
+// =============================================================================
+// MATH
+// =============================================================================
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+long random(long howbig) {
+    if (howbig == 0) return 0;
+    return rand() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+    srand((unsigned)seed);
+}
+
+// =============================================================================
+// PRINT
+// =============================================================================
+
+size_t Print::write(const char* str) {
+    if (str == NULL) return 0;
+    return write((const uint8_t*)str, strlen(str));
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper* str) {
+    return write(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const char* str) {
+    return write(str);
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char n, int base) {
+    return print((unsigned long)n, base);
+}
+
+size_t Print::print(int n, int base) {
+    return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base) {
+    return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base) {
+    if (base == DEC && n < 0) {
+        return print('-') + _printNumber((unsigned long)-n, DEC);
+    }
+    return _printNumber((unsigned long)n, (uint8_t)base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+    return _printNumber(n, (uint8_t)base);
+}
+
+size_t Print::print(double n, int digits) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+}
+
+size_t Print::println() {
+    return write("\r\n");
+}
+
+size_t Print::_printNumber(unsigned long n, uint8_t base) {
+    char buf[8 * sizeof(long) + 1];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    if (base < 2) base = 10;
+    do {
+        char c = n % base;
+        n /= base;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (n);
+    return write(str);
+}
+
+// =============================================================================
+// SERIAL
+// =============================================================================
+
+namespace sim {
+int serialAvailable();
+int serialRead();
+int serialPeek();
+void serialWrite(uint8_t c);
+}
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud) {
+    (void)baud;
+}
+
+int HardwareSerial::available() {
+    return sim::serialAvailable();
+}
+
+int HardwareSerial::read() {
+    return sim::serialRead();
+}
+
+int HardwareSerial::peek() {
+    return sim::serialPeek();
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    sim::serialWrite(c);
+    return 1;
+}
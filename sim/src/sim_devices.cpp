@@ -0,0 +1,306 @@
+/**
+ * @file sim_devices.cpp
+ * @brief Servo, NeoPixel and voice module shims for the native build
+ * @version 1.0.0
+ */
+
+#include "sim_trace.h"
+#include <Arduino.h>
+#include <Servo.h>
+#include <Adafruit_NeoPixel.h>
+#include <DFRobot_DF2301Q.h>
+
+namespace sim {
+uint8_t takeVoiceCommand();
+}
+
+// =============================================================================
+// SERVO TIMER MODEL
+// =============================================================================
+
+// Like the AVR Servo library, every constructed Servo owns a slot in a
+// 20 ms frame on Timer1 (clk/8, 2 ticks per us). Pulses run back to back
+// from the start of the frame, then the timer idles until the next one.
+
+#define SIM_MAX_SERVOS      12
+#define SIM_TICKS_PER_US    2
+
+namespace {
+
+uint16_t g_pulseUs[SIM_MAX_SERVOS];
+bool g_active[SIM_MAX_SERVOS];
+uint8_t g_servoCount = 0;
+bool g_timerRunning = false;
+uint64_t g_timerEpochUs = 0;
+
+/**
+ * @brief Microseconds since the start of the current servo frame
+ */
+uint32_t frameOffsetUs(uint64_t atUs) {
+    return (uint32_t)((atUs - g_timerEpochUs) % REFRESH_INTERVAL);
+}
+
+} // namespace
+
+namespace sim {
+
+bool servoTimerRunning() {
+    return g_timerRunning;
+}
+
+uint16_t servoTimerCount() {
+    if (!g_timerRunning) return 0;
+    return (uint16_t)(frameOffsetUs(nowUs()) * SIM_TICKS_PER_US);
+}
+
+uint16_t servoTimerCompare() {
+    uint32_t offset = frameOffsetUs(nowUs());
+    uint32_t pulseEnd = 0;
+    for (uint8_t i = 0; i < g_servoCount; i++) {
+        pulseEnd += g_pulseUs[i];
+        if (pulseEnd > offset) return (uint16_t)(pulseEnd * SIM_TICKS_PER_US);
+    }
+    return (uint16_t)(REFRESH_INTERVAL * SIM_TICKS_PER_US);
+}
+
+void interruptsBlocked(uint64_t startUs, uint64_t endUs) {
+    if (!g_timerRunning || endUs <= startUs) return;
+
+    uint64_t frameStart = startUs - frameOffsetUs(startUs);
+    for (; frameStart < endUs; frameStart += REFRESH_INTERVAL) {
+        uint64_t pulseEnd = frameStart;
+        for (uint8_t i = 0; i < g_servoCount; i++) {
+            pulseEnd += g_pulseUs[i];
+            if (g_active[i] && pulseEnd > startUs && pulseEnd < endUs) {
+                record(Event::SERVO_JITTER, i, (long)(endUs - pulseEnd));
+            }
+        }
+    }
+}
+
+} // namespace sim
+
+// =============================================================================
+// SERVO
+// =============================================================================
+
+Servo::Servo()
+    : _channel(g_servoCount < SIM_MAX_SERVOS ? g_servoCount++ : -1)
+    , _pin(-1)
+    , _angle(90)
+    , _min(MIN_PULSE_WIDTH)
+    , _max(MAX_PULSE_WIDTH) {
+    if (_channel >= 0) g_pulseUs[_channel] = DEFAULT_PULSE_WIDTH;
+}
+
+uint8_t Servo::attach(int pin) {
+    return attach(pin, MIN_PULSE_WIDTH, MAX_PULSE_WIDTH);
+}
+
+uint8_t Servo::attach(int pin, int min, int max) {
+    _pin = (int8_t)pin;
+    _min = min;
+    _max = max;
+    sim::record(sim::Event::SERVO_ATTACH, pin, 0);
+
+    if (_channel >= 0) g_active[_channel] = true;
+    if (!g_timerRunning) {
+        g_timerRunning = true;
+        g_timerEpochUs = sim::nowUs();
+    }
+    return _channel;
+}
+
+void Servo::detach() {
+    sim::record(sim::Event::SERVO_DETACH, _pin, 0);
+    _pin = -1;
+    // The slot keeps its place in the frame, as in the real library
+    if (_channel >= 0) g_active[_channel] = false;
+}
+
+void Servo::write(int value) {
+    // Same clamping as the AVR library: values below 544 are angles
+    if (value < MIN_PULSE_WIDTH) {
+        value = constrain(value, 0, 180);
+        _angle = value;
+        if (_channel >= 0) g_pulseUs[_channel] = (uint16_t)map(value, 0, 180, _min, _max);
+        sim::record(sim::Event::SERVO_WRITE, _pin, value);
+    } else {
+        writeMicroseconds(value);
+    }
+}
+
+void Servo::writeMicroseconds(int value) {
+    value = constrain(value, _min, _max);
+    _angle = (int)map(value, _min, _max, 0, 180);
+    if (_channel >= 0) g_pulseUs[_channel] = (uint16_t)value;
+    sim::record(sim::Event::SERVO_WRITE, _pin, _angle);
+}
+
+int Servo::read() {
+    return _angle;
+}
+
+int Servo::readMicroseconds() {
+    return (int)map(_angle, 0, 180, _min, _max);
+}
+
+bool Servo::attached() {
+    return _pin >= 0;
+}
+
+// =============================================================================
+// NEOPIXEL
+// =============================================================================
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, neoPixelType type)
+    : endTime(0)
+    , _begun(false)
+    , _numLEDs(0)
+    , _numBytes(0)
+    , _pin(pin)
+    , _brightness(0)
+    , _pixels(NULL) {
+    (void)type;
+    updateLength(n);
+}
+
+Adafruit_NeoPixel::Adafruit_NeoPixel()
+    : endTime(0)
+    , _begun(false)
+    , _numLEDs(0)
+    , _numBytes(0)
+    , _pin(-1)
+    , _brightness(0)
+    , _pixels(NULL) {
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel() {
+    free(_pixels);
+}
+
+void Adafruit_NeoPixel::begin() {
+    if (_pin >= 0) pinMode(_pin, OUTPUT);
+    _begun = true;
+}
+
+void Adafruit_NeoPixel::updateLength(uint16_t n) {
+    free(_pixels);
+    _numBytes = n * 3;
+    _pixels = _numBytes ? (uint8_t*)calloc(_numBytes, 1) : NULL;
+    _numLEDs = _pixels ? n : 0;
+    if (!_pixels) _numBytes = 0;
+}
+
+void Adafruit_NeoPixel::setPin(int16_t pin) {
+    // Like the real library, the old pin is released to INPUT
+    if (_begun && _pin >= 0) pinMode(_pin, INPUT);
+    _pin = pin;
+    if (_begun) {
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, LOW);
+    }
+}
+
+bool Adafruit_NeoPixel::canShow() {
+    uint32_t now = micros();
+    if (endTime > now) endTime = now;
+    return (now - endTime) >= 300L;
+}
+
+void Adafruit_NeoPixel::show() {
+    if (!_pixels) return;
+
+    // Wait for the previous frame to latch
+    while (!canShow()) {
+    }
+
+    // Record a cheap checksum of the frame so changes are visible in traces
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < _numBytes; i++) {
+        sum = sum * 31 + _pixels[i];
+    }
+    sim::record(sim::Event::PIXEL_SHOW, _pin, (long)sum);
+
+    // 24 bits at 800 kHz per pixel, sent with interrupts off
+    uint64_t start = sim::nowUs();
+    sim::setInterruptsEnabled(false);
+    sim::advanceUs(_numLEDs * 30UL);
+    sim::interruptsBlocked(start, sim::nowUs());
+    sim::setInterruptsEnabled(true);
+    endTime = micros();
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+    if (n >= _numLEDs) return;
+    if (_brightness) {
+        r = (r * _brightness) >> 8;
+        g = (g * _brightness) >> 8;
+        b = (b * _brightness) >> 8;
+    }
+    uint8_t* p = &_pixels[n * 3];
+    p[0] = g;
+    p[1] = r;
+    p[2] = b;
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c) {
+    setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+void Adafruit_NeoPixel::fill(uint32_t c, uint16_t first, uint16_t count) {
+    if (first >= _numLEDs) return;
+    uint16_t end = (count == 0 || first + count > _numLEDs) ? _numLEDs : first + count;
+    for (uint16_t i = first; i < end; i++) setPixelColor(i, c);
+}
+
+void Adafruit_NeoPixel::setBrightness(uint8_t b) {
+    // Same lossy in-place rescale as the real library
+    uint8_t newBrightness = b + 1;
+    if (newBrightness == _brightness) return;
+    uint8_t oldBrightness = _brightness - 1;
+    uint16_t scale;
+    if (oldBrightness == 0) {
+        scale = 0;
+    } else if (b == 255) {
+        scale = 65535 / oldBrightness;
+    } else {
+        scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;
+    }
+    for (uint16_t i = 0; i < _numBytes; i++) {
+        _pixels[i] = (_pixels[i] * scale) >> 8;
+    }
+    _brightness = newBrightness;
+}
+
+void Adafruit_NeoPixel::clear() {
+    if (_pixels) memset(_pixels, 0, _numBytes);
+}
+
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const {
+    if (n >= _numLEDs) return 0;
+    const uint8_t* p = &_pixels[n * 3];
+    uint8_t r = p[1], g = p[0], b = p[2];
+    if (_brightness) {
+        r = (r << 8) / _brightness;
+        g = (g << 8) / _brightness;
+        b = (b << 8) / _brightness;
+    }
+    return Color(r, g, b);
+}
+
+// =============================================================================
+// DFROBOT DF2301Q
+// =============================================================================
+
+bool DFRobot_DF2301Q_I2C::begin() {
+    return true;
+}
+
+uint8_t DFRobot_DF2301Q_I2C::getCMDID() {
+    return sim::takeVoiceCommand();
+}
+
+void DFRobot_DF2301Q_I2C::playByCMDID(uint8_t cmdId) {
+    (void)cmdId;
+}
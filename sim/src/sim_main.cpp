@@ -0,0 +1,172 @@
+/**
+ * @file sim_main.cpp
+ * @brief Entry point for the host-native SBot simulation
+ * @version 1.0.0
+ *
+ * Runs setup() then loop() against the virtual clock until the requested
+ * virtual run time has elapsed, then prints a summary of the recorded
+ * hardware calls.
+ *
+ * Usage:
+ *   program [--run MS] [--serial MS:TEXT]... [--voice MS:ID]...
+ *           [--light VALUE] [--stall EVERY_MS:LENGTH_MS] [--trace FILE]
+ *           [--quiet]
+ *
+ * Unit tests under test/ link the same sources with their own main(),
+ * so this one is left out when PIO_UNIT_TESTING is defined.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "sim_trace.h"
+#include <Arduino.h>
+
+#ifndef PIO_UNIT_TESTING
+
+// Virtual cost of one pass through loop()
+#define SIM_LOOP_COST_US  10
+
+// Servo writes further apart than this belong to separate moves
+#define SIM_SWEEP_GAP_US  1000000
+
+static bool parseTimed(const char* arg, uint32_t* atMs, const char** rest) {
+    const char* colon = strchr(arg, ':');
+    if (colon == NULL) return false;
+    *atMs = (uint32_t)strtoul(arg, NULL, 10);
+    *rest = colon + 1;
+    return true;
+}
+
+/**
+ * @brief Print how evenly servo sweeps were updated
+ *
+ * A sweep is a run of writes to one servo that keep moving the same
+ * way. The gap between two writes of a sweep is the update interval the
+ * servo actually saw, and the step is how far it jumped.
+ */
+static void printServoUpdates() {
+    struct Sweep {
+        uint64_t timeUs;
+        int32_t angle;
+        int dir;
+    };
+    Sweep last[NUM_DIGITAL_PINS] = {};
+    bool seen[NUM_DIGITAL_PINS] = {};
+
+    uint32_t gaps[NUM_DIGITAL_PINS] = {};
+    uint64_t gapSum[NUM_DIGITAL_PINS] = {};
+    uint64_t gapMax[NUM_DIGITAL_PINS] = {};
+    int32_t stepMax[NUM_DIGITAL_PINS] = {};
+    for (const sim::TraceRecord& rec : sim::trace()) {
+        if (rec.event != sim::Event::SERVO_WRITE) continue;
+        if (rec.pin < 0 || rec.pin >= NUM_DIGITAL_PINS) continue;
+        int pin = rec.pin;
+        Sweep& s = last[pin];
+        int dir = rec.value > s.angle ? 1 : (rec.value < s.angle ? -1 : 0);
+        uint64_t gap = rec.timeUs - s.timeUs;
+
+        if (seen[pin] && dir != 0 && dir == s.dir && gap < SIM_SWEEP_GAP_US) {
+            gaps[pin]++;
+            gapSum[pin] += gap;
+            if (gap > gapMax[pin]) gapMax[pin] = gap;
+            int32_t step = dir > 0 ? rec.value - s.angle : s.angle - rec.value;
+            if (step > stepMax[pin]) stepMax[pin] = step;
+        }
+        s.timeUs = rec.timeUs;
+        s.angle = rec.value;
+        s.dir = dir;
+        seen[pin] = true;
+    }
+
+    for (int pin = 0; pin < NUM_DIGITAL_PINS; pin++) {
+        if (gaps[pin] == 0) continue;
+        fprintf(stderr, "servo pin %-3d: max gap %.1f ms, mean %.1f ms, max step %d deg\n",
+                pin, gapMax[pin] / 1000.0, gapSum[pin] / 1000.0 / gaps[pin], stepMax[pin]);
+    }
+}
+
+static void writeTrace(const char* path) {
+    FILE* out = fopen(path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "sim: cannot open %s\n", path);
+        return;
+    }
+    fprintf(out, "time_us,event,pin,value\n");
+    for (const sim::TraceRecord& rec : sim::trace()) {
+        fprintf(out, "%llu,%s,%d,%ld\n", (unsigned long long)rec.timeUs,
+                sim::eventName(rec.event), rec.pin, (long)rec.value);
+    }
+    fclose(out);
+}
+
+int main(int argc, char** argv) {
+    uint32_t runMs = 60000;
+    const char* tracePath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        uint32_t atMs;
+        const char* rest;
+        if (strcmp(argv[i], "--run") == 0 && i + 1 < argc) {
+            runMs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--serial") == 0 && i + 1 < argc
+                   && parseTimed(argv[++i], &atMs, &rest)) {
+            sim::queueSerialInput(atMs, rest);
+        } else if (strcmp(argv[i], "--voice") == 0 && i + 1 < argc
+                   && parseTimed(argv[++i], &atMs, &rest)) {
+            sim::queueVoiceCommand(atMs, (uint8_t)atoi(rest));
+        } else if (strcmp(argv[i], "--light") == 0 && i + 1 < argc) {
+            sim::setAnalogValue(A2, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--stall") == 0 && i + 1 < argc
+                   && parseTimed(argv[++i], &atMs, &rest)) {
+            sim::setForegroundStall(atMs, (uint32_t)strtoul(rest, NULL, 10));
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            sim::setSerialEcho(false);
+        } else {
+            fprintf(stderr, "sim: unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    clock_t wallStart = clock();
+
+    setup();
+    while (sim::nowUs() < (uint64_t)runMs * 1000) {
+        loop();
+        sim::advanceUs(SIM_LOOP_COST_US);
+    }
+
+    double wallMs = (double)(clock() - wallStart) * 1000.0 / CLOCKS_PER_SEC;
+
+    fflush(stdout);
+    fprintf(stderr, "\n=== sim summary ===\n");
+    fprintf(stderr, "virtual time : %llu ms\n", (unsigned long long)(sim::nowUs() / 1000));
+    fprintf(stderr, "host time    : %.1f ms\n", wallMs);
+    for (uint8_t e = 0; e < (uint8_t)sim::Event::COUNT; e++) {
+        uint32_t n = sim::count((sim::Event)e);
+        if (n > 0) fprintf(stderr, "%-13s: %u\n", sim::eventName((sim::Event)e), n);
+    }
+
+    // Servo pulse error caused by interrupts-off spans (NeoPixel show)
+    uint32_t jitterCount = 0;
+    long jitterMax = 0;
+    long jitterSum = 0;
+    for (const sim::TraceRecord& rec : sim::trace()) {
+        if (rec.event != sim::Event::SERVO_JITTER) continue;
+        jitterCount++;
+        jitterSum += rec.value;
+        if (rec.value > jitterMax) jitterMax = rec.value;
+    }
+    if (jitterCount > 0) {
+        fprintf(stderr, "pulse error  : max %ld us, mean %ld us\n", jitterMax, jitterSum / (long)jitterCount);
+    }
+
+    printServoUpdates();
+
+    if (tracePath != NULL) writeTrace(tracePath);
+    return 0;
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,37 @@
+/**
+ * @file ambient_light.cpp
+ * @brief Ambient light sensing for LED auto-dimming
+ * @version 1.0.0
+ */
+
+#include "ambient_light.h"
+
+// Brightness gained per light level, in 8.8 fixed point
+#define LIGHT_SLOPE \
+    (((255UL - LIGHT_BRIGHTNESS_MIN) << 8) / (LIGHT_LEVEL_BRIGHT - LIGHT_LEVEL_DARK))
+
+static_assert(LIGHT_LEVEL_BRIGHT > LIGHT_LEVEL_DARK, "Light levels out of order");
+static_assert(LIGHT_FILTER_SHIFT <= 6, "Filtered level must fit 16 bits");
+
+AmbientLight::AmbientLight(uint8_t pin)
+    : _pin(pin)
+    , _filtered(0) {
+}
+
+void AmbientLight::begin() {
+    pinMode(_pin, INPUT);
+    _filtered = (uint16_t)analogRead(_pin) << LIGHT_FILTER_SHIFT;
+}
+
+uint8_t AmbientLight::sample() {
+    // filtered += reading - filtered / 2^n, all scaled by 2^n
+    _filtered = _filtered - (_filtered >> LIGHT_FILTER_SHIFT) + analogRead(_pin);
+    return getBrightness();
+}
+
+uint8_t AmbientLight::getBrightness() const {
+    uint16_t level = getLevel();
+    if (level <= LIGHT_LEVEL_DARK) return LIGHT_BRIGHTNESS_MIN;
+    if (level >= LIGHT_LEVEL_BRIGHT) return 255;
+    return LIGHT_BRIGHTNESS_MIN + (((uint32_t)(level - LIGHT_LEVEL_DARK) * LIGHT_SLOPE) >> 8);
+}
@@ -0,0 +1,127 @@
+/**
+ * @file color_math.cpp
+ * @brief PROGMEM easing tables and fixed-point interpolation
+ * @version 1.0.0
+ */
+
+#include "color_math.h"
+
+// Curves are sampled at 33 points (32 segments) over x = 0..1, scaled
+// to 0..65535
+#define EASE_SEGMENT_SHIFT  11
+#define EASE_FRACTION_SHIFT 3
+
+// (1 - cos(pi * x)) / 2
+static const uint16_t EASE_IN_OUT_TABLE[33] PROGMEM = {
+        0,   158,   630,  1411,  2494,  3869,  5522,  7438,
+     9597, 11980, 14563, 17321, 20228, 23256, 26375, 29556,
+    32767, 35979, 39160, 42279, 45307, 48214, 50972, 53555,
+    55938, 58097, 60013, 61666, 63041, 64124, 64905, 65377,
+    65535
+};
+
+// x ^ 2.6, the curve of Adafruit_NeoPixel::gamma8()
+static const uint16_t GAMMA_TABLE[33] PROGMEM = {
+        0,     8,    49,   139,   294,   525,   844,  1260,
+     1783,  2422,  3185,  4080,  5116,  6300,  7639,  9139,
+    10809, 12655, 14682, 16898, 19309, 21921, 24739, 27770,
+    31019, 34493, 38196, 42134, 46312, 50736, 55411, 60343,
+    65535
+};
+
+// sin(pi * x) ^ 2, gamma corrected
+static const uint16_t SINE_BREATH_TABLE[33] PROGMEM = {
+        0,     0,    13,   105,   444,  1312,  3084,  6148,
+    10809, 17181, 25100, 34096, 43418, 52128, 59246, 63911,
+    65535, 63911, 59246, 52128, 43418, 34096, 25100, 17181,
+    10809,  6148,  3084,  1312,   444,   105,    13,     0,
+        0
+};
+
+/**
+ * @brief Sample a curve table between its points
+ */
+static uint16_t sampleTable(const uint16_t* table, uint16_t position) {
+    uint8_t segment = position >> EASE_SEGMENT_SHIFT;
+    uint8_t fraction = (uint8_t)(position >> EASE_FRACTION_SHIFT);
+    uint16_t a = pgm_read_word(&table[segment]);
+    uint16_t b = pgm_read_word(&table[segment + 1]);
+
+    if (b >= a) {
+        return a + (uint16_t)(((uint32_t)(b - a) * fraction) >> 8);
+    }
+    return a - (uint16_t)(((uint32_t)(a - b) * fraction) >> 8);
+}
+
+uint32_t progressRate(uint32_t durationMs) {
+    return durationMs > 0 ? 0xFFFFFFUL / durationMs : 0xFFFFFFUL;
+}
+
+uint16_t ease(Easing curve, uint16_t position) {
+    switch (curve) {
+        case Easing::EASE_IN_OUT:
+            return sampleTable(EASE_IN_OUT_TABLE, position);
+        case Easing::GAMMA_IN:
+            return sampleTable(GAMMA_TABLE, position);
+        case Easing::GAMMA_OUT:
+            // Mirror image of GAMMA_IN: falls quickly while still bright
+            return COLOR_MATH_POSITION_MAX -
+                   sampleTable(GAMMA_TABLE, COLOR_MATH_POSITION_MAX - position);
+        case Easing::SINE_BREATH:
+            return sampleTable(SINE_BREATH_TABLE, position);
+        case Easing::LINEAR:
+        default:
+            return position;
+    }
+}
+
+RGBColor lerpColor(RGBColor from, RGBColor to, uint16_t position) {
+    // Weight 0..256, so both ends are hit exactly and no division is needed
+    uint16_t w = (position >> 8) + (position >> 15);
+    uint16_t inv = 256 - w;
+    return RGBColor((from.r * inv + to.r * w) >> 8,
+                    (from.g * inv + to.g * w) >> 8,
+                    (from.b * inv + to.b * w) >> 8);
+}
+
+/**
+ * @brief One 8.8 channel of lerpColorFine()
+ */
+static uint16_t lerpChannelFine(uint8_t from, uint8_t to, uint32_t weight) {
+    int32_t delta = ((int32_t)(to - from) * (int32_t)weight) >> 8;
+    return (uint16_t)(((int32_t)from << 8) + delta);
+}
+
+RGBColor16 lerpColorFine(RGBColor from, RGBColor to, uint16_t position) {
+    // Weight 0..65536, for the same exact ends as lerpColor()
+    uint32_t w = (uint32_t)position + (position >> 15);
+    RGBColor16 color;
+    color.r = lerpChannelFine(from.r, to.r, w);
+    color.g = lerpChannelFine(from.g, to.g, w);
+    color.b = lerpChannelFine(from.b, to.b, w);
+    return color;
+}
+
+RGBColor hsvToRgb(uint8_t hue, uint8_t saturation, uint8_t value) {
+    // Six sectors of 256 steps: the multiply replaces a divide by 42.5
+    uint16_t scaled = hue * 6;
+    uint8_t sector = scaled >> 8;
+    uint8_t fraction = (uint8_t)scaled;
+    
+    // Weights 0..256, so full saturation reaches 0 and value is exact.
+    // The sloped channels keep the full 16-bit s * fraction product and
+    // round once, which holds every channel within 1 LSB of float HSV
+    uint16_t s = saturation + (saturation >> 7);
+    uint8_t low = (value * (256 - s) + 128) >> 8;
+    uint8_t falling = ((uint32_t)value * (65536UL - s * fraction) + 32768) >> 16;
+    uint8_t rising = ((uint32_t)value * (65536UL - s * (256 - fraction)) + 32768) >> 16;
+    
+    switch (sector) {
+        case 0:  return RGBColor(value, rising, low);
+        case 1:  return RGBColor(falling, value, low);
+        case 2:  return RGBColor(low, value, rising);
+        case 3:  return RGBColor(low, falling, value);
+        case 4:  return RGBColor(rising, low, value);
+        default: return RGBColor(value, low, falling);
+    }
+}
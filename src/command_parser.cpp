@@ -0,0 +1,97 @@
+/**
+ * @file command_parser.cpp
+ * @brief Implementation of the non-blocking serial command parser
+ * @version 1.0.0
+ */
+
+#include "command_parser.h"
+
+/**
+ * @brief One keyword in the command table
+ */
+struct CommandEntry {
+    char name[8];
+    SerialCommand command;
+};
+
+// Must stay sorted by name (strcmp order) for the binary search
+static const CommandEntry COMMAND_TABLE[] PROGMEM = {
+    { "chill",   SerialCommand::CHILL   },
+    { "demo",    SerialCommand::STARTUP },
+    { "dope",    SerialCommand::DOPE    },
+    { "help",    SerialCommand::HELP    },
+    { "home",    SerialCommand::HOME    },
+    { "startup", SerialCommand::STARTUP },
+    { "stats",   SerialCommand::STATS   },
+};
+static const uint8_t COMMAND_COUNT = sizeof(COMMAND_TABLE) / sizeof(CommandEntry);
+
+CommandParser::CommandParser()
+    : _length(0)
+    , _overflow(false) {
+    _buffer[0] = '\0';
+}
+
+SerialCommand CommandParser::poll(Stream& input) {
+    while (input.available() > 0) {
+        char c = input.read();
+        
+        if (c == '\n' || c == '\r') {
+            // Trim trailing whitespace
+            while (_length > 0 && _buffer[_length - 1] == ' ') {
+                _length--;
+            }
+            _buffer[_length] = '\0';
+            
+            bool overflow = _overflow;
+            bool empty = (_length == 0);
+            SerialCommand command = (empty || overflow) ? SerialCommand::NONE : _lookup();
+            reset();
+            
+            if (overflow) return SerialCommand::UNKNOWN;
+            if (!empty) return command;
+            continue;   // Blank line (or the \n of a \r\n pair)
+        }
+        
+        // Skip leading whitespace
+        if ((c == ' ' || c == '\t') && _length == 0) continue;
+        if (c == '\t') c = ' ';
+        
+        if (_length < SERIAL_COMMAND_MAX_LENGTH) {
+            if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+            _buffer[_length++] = c;
+        } else {
+            // Too long for any command: drop the rest of the line
+            _overflow = true;
+        }
+    }
+    
+    return SerialCommand::NONE;
+}
+
+void CommandParser::reset() {
+    _length = 0;
+    _overflow = false;
+    _buffer[0] = '\0';
+}
+
+SerialCommand CommandParser::_lookup() const {
+    uint8_t low = 0;
+    uint8_t high = COMMAND_COUNT;
+    
+    while (low < high) {
+        uint8_t mid = (low + high) / 2;
+        int cmp = strcmp_P(_buffer, COMMAND_TABLE[mid].name);
+        
+        if (cmp == 0) {
+            return (SerialCommand)pgm_read_byte(&COMMAND_TABLE[mid].command);
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    
+    return SerialCommand::UNKNOWN;
+}
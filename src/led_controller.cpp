@@ -7,11 +7,119 @@
 #include "led_controller.h"
 #include <Arduino.h>
 
-LEDController::LEDController(uint8_t pin1, uint8_t pin2, uint8_t numPixels)
+// Blocking wrappers keep the timing of the original LED_FADE_STEPS loops
+#define BREATHE_RAMP_MS     (LED_FADE_STEPS * 10)
+#define BREATHE_PAUSE_MS    200
+#define BREATHE_PERIOD_MS   (2 * BREATHE_RAMP_MS + BREATHE_PAUSE_MS)
+#define BREATHE_RATE        (0xFFFFFFUL / (2 * BREATHE_RAMP_MS))
+
+// Strips awaiting show(); in MIRROR mode LEFT stands for the shared buffer
+#define LED_DIRTY_LEFT      0x01
+#define LED_DIRTY_RIGHT     0x02
+#define LED_DIRTY_ALL       (LED_DIRTY_LEFT | LED_DIRTY_RIGHT)
+
+// Slots of the overlay layers in _layers (BASE is the engine itself)
+#define LED_LAYER_OVERLAY   0
+#define LED_LAYER_NOTIFY    1
+
+// Refresh period while a dithered color is showing
+#define LED_DITHER_INTERVAL_MS  (1000 / LED_DITHER_FPS)
+#define LED_DITHER_FRACTION_MASK \
+    ((uint16_t)(((1 << LED_DITHER_BITS) - 1) << (8 - LED_DITHER_BITS)))
+
+// show() keeps interrupts off for 30 us per pixel plus some setup
+#define LED_SHOW_US_PER_PIXEL   30
+#define LED_SHOW_OVERHEAD_US    20
+
+// The Servo library restarts its timer (clk/8) at each 20 ms frame and
+// keeps the next pulse edge in OCRnA. It uses Timer5 on the Mega.
+#if defined(TCNT5)
+#define SERVO_TCNT          TCNT5
+#define SERVO_OCR           OCR5A
+#define SERVO_TIMSK         TIMSK5
+#define SERVO_OCIE          OCIE5A
+#else
+#define SERVO_TCNT          TCNT1
+#define SERVO_OCR           OCR1A
+#define SERVO_TIMSK         TIMSK1
+#define SERVO_OCIE          OCIE1A
+#endif
+#define SERVO_TICKS_PER_US  (F_CPU / 8000000UL)
+
+// =============================================================================
+// MIRRORED STRIP
+// =============================================================================
+
+void MirroredNeoPixel::swapPin(int16_t pin) {
+#if defined(__AVR__)
+    // Both pins are already outputs driven low by begin(), so only the
+    // port and mask used by the bit-bang loop change. setPin() would also
+    // float the old pin and redo pinMode() on every frame.
+    this->pin = pin;
+    port = portOutputRegister(digitalPinToPort(pin));
+    pinMask = digitalPinToBitMask(pin);
+#else
+    int16_t previous = getPin();
+    setPin(pin);
+    pinMode(previous, OUTPUT);
+    digitalWrite(previous, LOW);
+#endif
+    
+    uint32_t latch = endTime;
+    endTime = _otherEndTime;
+    _otherEndTime = latch;
+}
+
+// =============================================================================
+// LED CONTROLLER
+// =============================================================================
+
+LEDController::LEDController(uint8_t pin1, uint8_t pin2, uint16_t numPixels, LEDOutputMode mode)
     : _strip1(numPixels, pin1, NEO_GRB + NEO_KHZ800)
-    , _strip2(numPixels, pin2, NEO_GRB + NEO_KHZ800)
+    , _strip2(mode == LEDOutputMode::INDEPENDENT ? numPixels : 0, pin2, NEO_GRB + NEO_KHZ800)
+    , _pin1(pin1)
+    , _pin2(pin2)
     , _numPixels(numPixels)
-    , _currentColor(0, 0, 0) {
+    , _outputMode(mode)
+    , _brightness(255)
+    , _currentColor(0, 0, 0)
+    , _rightColor(0, 0, 0)
+    , _dirty(0)
+    , _frameInterval(LED_MAX_FPS > 0 ? 1000 / LED_MAX_FPS : 0)
+    , _lastFrame(0)
+    , _framesRequested(0)
+    , _framesPushed(0)
+    , _servoSyncMisses(0)
+#if SBOT_LED_DITHER
+    , _fine{0, 0, 0}
+    , _ditherError{0, 0, 0}
+    , _dithering(false)
+#endif
+    , _animation(LEDAnimation::NONE)
+    , _animStart(0)
+    , _animDuration(0)
+    , _animRate(0)
+    , _animEasing(Easing::LINEAR)
+    , _animSpeed(0)
+    , _hueSaturation(255)
+    , _hueValue(255)
+    , _timeline(nullptr)
+    , _timelineLength(0)
+    , _timelineIndex(0)
+    , _keyFadeMs(0)
+    , _effect(LEDEffect::CHASE)
+    , _effectParams()
+    , _effectMaxUs(0)
+    , _effectOverruns(0)
+    , _perPixel(false)
+    , _effectElapsed(0)
+    , _layers()
+    , _flashToggles(0)
+    , _flashAlpha(0)
+    , _flashOnMs(0)
+    , _flashOffMs(0)
+    , _flashNext(0)
+    , _animCallback(nullptr) {
 }
 
 void LEDController::begin() {
@@ -21,125 +129,530 @@ void LEDController::begin() {
     _strip2.setBrightness(255);
     off();
     
+    // The strips' power-on state is unknown, so always send the first frame
+    _dirty = LED_DIRTY_ALL;
+    flush();
+    
     DEBUG_PRINTLN(F("LED Controller initialized"));
 }
 
-void LEDController::setColor(const RGBColor& color) {
+void LEDController::setColor(RGBColor color) {
     setColor(color.r, color.g, color.b);
 }
 
 void LEDController::setColor(uint8_t r, uint8_t g, uint8_t b) {
-    _currentColor = RGBColor(r, g, b);
+    // An explicit color always wins over a running animation
+    _animation = LEDAnimation::NONE;
+    _show(r, g, b);
+}
+
+void LEDController::setHSV(uint8_t hue, uint8_t saturation, uint8_t value) {
+    setColor(hsvToRgb(hue, saturation, value));
+}
+
+void LEDController::setArmColors(RGBColor left, RGBColor right) {
+    if (_outputMode == LEDOutputMode::MIRROR) {
+        setColor(left);
+        return;
+    }
     
-    for (uint8_t i = 0; i < _numPixels; i++) {
-        _strip1.setPixelColor(i, _strip1.Color(r, g, b));
-        _strip2.setPixelColor(i, _strip2.Color(r, g, b));
+    _animation = LEDAnimation::NONE;
+#if SBOT_LED_DITHER
+    _dithering = false;
+#endif
+    _framesRequested++;
+    if (_perPixel || !_sameColor(left, _currentColor)) {
+        _currentColor = left;
+        _fill(_strip1, left);
+        _dirty |= LED_DIRTY_LEFT;
     }
-    _update();
+    if (_perPixel || !_sameColor(right, _rightColor)) {
+        _rightColor = right;
+        _fill(_strip2, right);
+        _dirty |= LED_DIRTY_RIGHT;
+    }
+    _perPixel = false;
 }
 
 void LEDController::off() {
     setColor(0, 0, 0);
 }
 
-void LEDController::fadeIn(const RGBColor& color, uint16_t duration) {
-    uint8_t steps = 51;  // 255 / 5
-    uint16_t stepDelay = duration / steps;
+// =============================================================================
+// BLOCKING EFFECTS (wrappers around the animation engine)
+// =============================================================================
+
+void LEDController::fadeIn(RGBColor color, uint16_t duration) {
+    startFadeIn(color, duration);
+    _runToCompletion();
+}
+
+void LEDController::fadeOut(uint16_t duration) {
+    startFadeOut(duration);
+    _runToCompletion();
+}
+
+void LEDController::crossfade(RGBColor from, RGBColor to, uint8_t stepDelay) {
+    startCrossfade(from, to, (uint16_t)stepDelay * LED_FADE_STEPS);
+    _runToCompletion();
+}
+
+void LEDController::playTimeline(const LEDKeyframe* timeline, uint8_t length) {
+    startTimeline(timeline, length);
+    _runToCompletion();
+}
+
+void LEDController::rainbow(uint8_t cycles, uint8_t speed, uint8_t saturation, uint8_t value) {
+    startRainbow(cycles, speed, saturation, value);
+    _runToCompletion();
+}
+
+void LEDController::breathe(RGBColor color, uint8_t cycles) {
+    startBreathe(color, cycles);
+    _runToCompletion();
+}
+
+// =============================================================================
+// NON-BLOCKING ANIMATION ENGINE
+// =============================================================================
+
+void LEDController::startFadeIn(RGBColor color, uint16_t duration) {
+    startCrossfade(Colors::BLACK, color, duration, Easing::GAMMA_IN);
+}
+
+void LEDController::startFadeOut(uint16_t duration) {
+    startCrossfade(_currentColor, Colors::BLACK, duration, Easing::GAMMA_OUT);
+}
+
+void LEDController::startCrossfade(RGBColor from, RGBColor to, uint16_t duration, Easing easing) {
+    _animFrom = from;
+    _animTo = to;
+    _animEasing = easing;
+    _animRate = progressRate(duration);
+    _show(from.r, from.g, from.b);
+    _startAnimation(LEDAnimation::FADE, duration);
+}
+
+void LEDController::startRainbow(uint8_t cycles, uint8_t speed, uint8_t saturation, uint8_t value) {
+    _animSpeed = speed > 0 ? speed : 1;
+    _hueSaturation = saturation;
+    _hueValue = value;
+    _startAnimation(LEDAnimation::RAINBOW, (uint32_t)cycles * 256 * _animSpeed);
+}
+
+void LEDController::startBreathe(RGBColor color, uint8_t cycles) {
+    _animTo = color;
+    _startAnimation(LEDAnimation::BREATHE, (uint32_t)cycles * BREATHE_PERIOD_MS);
+}
+
+void LEDController::startTimeline(const LEDKeyframe* timeline, uint8_t length) {
+    if (length == 0) return;
     
-    for (uint16_t i = 0; i <= 255; i += 5) {
-        uint8_t r = (color.r * i) / 255;
-        uint8_t g = (color.g * i) / 255;
-        uint8_t b = (color.b * i) / 255;
-        setColor(r, g, b);
-        delay(stepDelay);
+    _timeline = timeline;
+    _timelineLength = length;
+    _timelineIndex = 0;
+    _animTo = _currentColor;
+    _startAnimation(LEDAnimation::TIMELINE, 0);
+    _loadKeyframe();
+}
+
+void LEDController::startEffect(LEDEffect effect, const LEDEffectParams& params, uint32_t duration) {
+    _effect = effect;
+    _effectParams = params;
+    _startAnimation(LEDAnimation::EFFECT, duration > 0 ? duration : 0xFFFFFFFFUL);
+    
+    // Draw the first frame now rather than at the next frame slot
+    _renderEffect(0);
+}
+
+void LEDController::setLayer(LEDLayer layer, RGBColor color, uint8_t alpha) {
+    if (layer == LEDLayer::BASE) {
+        setColor(color);
+        return;
     }
     
-    // Ensure we end exactly on target color
-    setColor(color);
+    // Setting NOTIFY by hand cancels a running flash
+    if (layer == LEDLayer::NOTIFY) _flashToggles = 0;
+    
+    LEDLayerState& state = _layers[(uint8_t)layer - 1];
+    if (state.alpha == alpha && _sameColor(state.color, color)) return;
+    state.color = color;
+    state.alpha = alpha;
+    _recompose();
 }
 
-void LEDController::fadeOut(uint16_t duration) {
-    RGBColor startColor = _currentColor;
-    uint8_t steps = 51;
-    uint16_t stepDelay = duration / steps;
+void LEDController::flash(RGBColor color, uint8_t count, uint16_t onMs, uint16_t offMs, uint8_t alpha) {
+    if (count == 0) return;
     
-    for (int16_t i = 255; i >= 0; i -= 5) {
-        uint8_t r = (startColor.r * i) / 255;
-        uint8_t g = (startColor.g * i) / 255;
-        uint8_t b = (startColor.b * i) / 255;
-        setColor(r, g, b);
-        delay(stepDelay);
+    setLayer(LEDLayer::NOTIFY, color, alpha);
+    _flashAlpha = alpha;
+    _flashOnMs = onMs;
+    _flashOffMs = offMs;
+    _flashToggles = (uint16_t)count * 2 - 1;
+    _flashNext = millis() + onMs;
+}
+
+bool LEDController::update(uint32_t now) {
+    _updateFlash(now);
+    bool running = _animate(now);
+    
+#if SBOT_LED_DITHER
+    // A dithered color needs a new frame at the refresh rate even when
+    // the animation has not moved
+    if (_dithering) {
+        if ((uint32_t)(now - _lastFrame) >= LED_DITHER_INTERVAL_MS) {
+            _lastFrame = now;
+            _ditherStep();
+            if (_dirty) _push();
+        }
+        return running;
     }
+#endif
     
-    off();
+    // Coalesce everything written since the last frame into one show()
+    if (_dirty && (uint32_t)(now - _lastFrame) >= _frameInterval) {
+        _lastFrame = now;
+        _push();
+    }
+    return running;
+}
+
+void LEDController::flush() {
+    if (_dirty) {
+        _lastFrame = millis();
+        _push();
+    }
 }
 
-void LEDController::crossfade(const RGBColor& from, const RGBColor& to, uint8_t stepDelay) {
-    for (uint16_t i = 0; i <= 255; i += 5) {
-        uint8_t r = map(i, 0, 255, from.r, to.r);
-        uint8_t g = map(i, 0, 255, from.g, to.g);
-        uint8_t b = map(i, 0, 255, from.b, to.b);
-        setColor(r, g, b);
-        delay(stepDelay);
+void LEDController::setMaxFps(uint8_t fps) {
+    _frameInterval = fps > 0 ? 1000 / fps : 0;
+}
+
+void LEDController::resetFrameStats() {
+    _framesRequested = 0;
+    _framesPushed = 0;
+    _servoSyncMisses = 0;
+    _effectMaxUs = 0;
+    _effectOverruns = 0;
+}
+
+bool LEDController::_animate(uint32_t now) {
+    if (_animation == LEDAnimation::NONE) return false;
+    
+    uint32_t elapsed = now - _animStart;
+    
+    // A light show moves on to its next keyframe instead of ending
+    while (_animation == LEDAnimation::TIMELINE && elapsed >= _animDuration &&
+           _timelineIndex < _timelineLength) {
+        _animStart += _animDuration;
+        elapsed -= _animDuration;
+        _loadKeyframe();
     }
     
-    // Ensure we end exactly on target color
-    setColor(to);
+    if (elapsed >= _animDuration) {
+        // Settle on the final frame, then notify
+        if (_animation == LEDAnimation::FADE || _animation == LEDAnimation::TIMELINE) {
+            _show(_animTo.r, _animTo.g, _animTo.b);
+        } else if (_animation == LEDAnimation::BREATHE) {
+            _show(0, 0, 0);
+        }
+        _animation = LEDAnimation::NONE;
+        
+        if (_animCallback) _animCallback();
+        return false;
+    }
+    
+    // Every frame is a blend; RAINBOW just sits at the end of it
+    RGBColor from = Colors::BLACK;
+    RGBColor to;
+    uint16_t position = COLOR_MATH_POSITION_MAX;
+    switch (_animation) {
+        case LEDAnimation::FADE:
+            from = _animFrom;
+            to = _animTo;
+            position = ease(_animEasing, progressAt(elapsed, _animRate));
+            break;
+            
+        case LEDAnimation::TIMELINE:
+            // Fade, then hold the keyframe color
+            from = _animFrom;
+            to = _animTo;
+            if (elapsed < _keyFadeMs) {
+                position = ease(_animEasing, progressAt(elapsed, _animRate));
+            }
+            break;
+            
+        case LEDAnimation::EFFECT:
+            // Only compute frames that will actually be pushed
+            if ((uint32_t)(now - _lastFrame) >= _frameInterval) {
+                _renderEffect(elapsed);
+            }
+            return true;
+            
+        case LEDAnimation::RAINBOW:
+            to = hsvToRgb((elapsed / _animSpeed) & 0xFF, _hueSaturation, _hueValue);
+            break;
+            
+        case LEDAnimation::BREATHE: {
+            // One breath up and down, then a pause in the dark
+            uint16_t phase = elapsed % BREATHE_PERIOD_MS;
+            to = _animTo;
+            position = 0;
+            if (phase < 2 * BREATHE_RAMP_MS) {
+                position = ease(Easing::SINE_BREATH, progressAt(phase, BREATHE_RATE));
+            }
+            break;
+        }
+            
+        default:
+            break;
+    }
+    
+    _showBlend(from, to, position);
+    return true;
+}
+
+void LEDController::stopAnimation() {
+    _animation = LEDAnimation::NONE;
+#if SBOT_LED_DITHER
+    // Hold whichever dithered frame is showing
+    _dithering = false;
+#endif
+}
+
+void LEDController::setOutputMode(LEDOutputMode mode) {
+    if (mode == _outputMode) return;
+    _outputMode = mode;
+    
+    if (mode == LEDOutputMode::INDEPENDENT) {
+        _strip2.updateLength(_numPixels);
+        _strip2.setBrightness(_strip1.getBrightness());
+        _fill(_strip2, _currentColor);
+    } else {
+        _strip2.updateLength(0);
+    }
+    
+    // The right arm now shows a different buffer
+    _rightColor = _currentColor;
+    _framesRequested++;
+    _dirty = LED_DIRTY_ALL;
+}
+
+void LEDController::setBrightness(uint8_t brightness) {
+    if (brightness == _brightness) return;
+    _brightness = brightness;
+    
+    // Rebuild from the unscaled colors; the strips themselves stay at full
+    _recompose();
+}
+
+void LEDController::_push() {
+    if (_outputMode == LEDOutputMode::MIRROR) {
+        // Same buffer to the left arm, then the right arm
+        _showAligned(_strip1);
+        _strip1.swapPin(_pin2);
+        _showAligned(_strip1);
+        _strip1.swapPin(_pin1);
+    } else {
+        if (_dirty & LED_DIRTY_LEFT) _showAligned(_strip1);
+        if (_dirty & LED_DIRTY_RIGHT) _showAligned(_strip2);
+    }
+    _dirty = 0;
+    _framesPushed++;
+}
+
+void LEDController::_showAligned(Adafruit_NeoPixel& strip) {
+#if ENABLE_LED_SERVO_SYNC
+    // show() waits for the latch before it disables interrupts; do that
+    // wait first so the quiet window is not spent inside it
+    while (!strip.canShow()) {
+    }
+    
+    uint16_t busyUs = strip.numPixels() * LED_SHOW_US_PER_PIXEL + LED_SHOW_OVERHEAD_US;
+    if (!_waitForServoQuiet(busyUs) && _servoSyncMisses < 0xFFFF) {
+        _servoSyncMisses++;
+    }
+#endif
+    strip.show();
+}
+
+bool LEDController::_waitForServoQuiet(uint16_t us) {
+    // No servo attached yet: the timer interrupt is off
+    if (!(SERVO_TIMSK & _BV(SERVO_OCIE))) return true;
+    
+    int32_t needed = (int32_t)us * SERVO_TICKS_PER_US;
+    uint32_t start = micros();
+    
+    while (true) {
+        noInterrupts();
+        int32_t remaining = (int32_t)SERVO_OCR - (int32_t)SERVO_TCNT;
+        interrupts();
+        
+        // remaining <= 0 means an edge is due and its interrupt is pending
+        if (remaining > needed) return true;
+        if (micros() - start >= LED_SERVO_SYNC_TIMEOUT_US) return false;
+    }
+}
+
+void LEDController::_show(uint8_t r, uint8_t g, uint8_t b) {
+#if SBOT_LED_DITHER
+    _dithering = false;
+#endif
+    _write(r, g, b);
+}
+
+void LEDController::_showBlend(RGBColor from, RGBColor to, uint16_t position) {
+#if SBOT_LED_DITHER
+    _fine = lerpColorFine(from, to, position);
+    
+    // Whole values need no dithering; show them as they are
+    if (!((_fine.r | _fine.g | _fine.b) & LED_DITHER_FRACTION_MASK)) {
+        _show(_fine.r >> 8, _fine.g >> 8, _fine.b >> 8);
+        return;
+    }
+    
+    // The next refresh tick (_ditherStep) turns _fine into a frame
+    if (!_dithering) {
+        _dithering = true;
+        _ditherStep();
+    }
+#else
+    RGBColor color = lerpColor(from, to, position);
+    _show(color.r, color.g, color.b);
+#endif
+}
+
+#if SBOT_LED_DITHER
+uint8_t LEDController::_ditherChannel(uint16_t fine, uint8_t& error) {
+    // First-order sigma-delta on the top LED_DITHER_BITS fractional bits:
+    // the fraction left over each frame carries into the next one
+    uint16_t sum = (fine >> (8 - LED_DITHER_BITS)) + error;
+    error = sum & ((1 << LED_DITHER_BITS) - 1);
+    sum >>= LED_DITHER_BITS;
+    return sum > 255 ? 255 : (uint8_t)sum;
 }
 
-void LEDController::rainbow(uint8_t cycles, uint8_t speed) {
-    for (uint8_t c = 0; c < cycles; c++) {
-        for (uint16_t hue = 0; hue < 256; hue++) {
-            RGBColor color = _wheel(hue);
-            setColor(color);
-            delay(speed);
+void LEDController::_ditherStep() {
+    _write(_ditherChannel(_fine.r, _ditherError[0]),
+           _ditherChannel(_fine.g, _ditherError[1]),
+           _ditherChannel(_fine.b, _ditherError[2]));
+}
+#endif
+
+void LEDController::_write(uint8_t r, uint8_t g, uint8_t b) {
+    RGBColor color(r, g, b);
+    _framesRequested++;
+    
+    // After an effect the buffers no longer match _currentColor
+    if (_perPixel || !_sameColor(color, _currentColor)) {
+        _currentColor = color;
+        _fill(_strip1, color);
+        _dirty |= LED_DIRTY_LEFT;
+    }
+    if (_outputMode == LEDOutputMode::INDEPENDENT) {
+        if (_perPixel || !_sameColor(color, _rightColor)) {
+            _fill(_strip2, color);
+            _dirty |= LED_DIRTY_RIGHT;
         }
     }
+    _rightColor = color;
+    _perPixel = false;
 }
 
-void LEDController::breathe(const RGBColor& color, uint8_t cycles) {
-    for (uint8_t c = 0; c < cycles; c++) {
-        // Breathe in
-        for (uint16_t i = 0; i <= 255; i += 5) {
-            uint8_t r = (color.r * i) / 255;
-            uint8_t g = (color.g * i) / 255;
-            uint8_t b = (color.b * i) / 255;
-            setColor(r, g, b);
-            delay(10);
+void LEDController::_renderEffect(uint32_t elapsed) {
+    uint32_t start = micros();
+    renderEffect(_effect, _effectParams, elapsed, _strip1);
+    for (uint8_t i = 0; i < LED_OVERLAY_LAYERS; i++) {
+        if (_layers[i].alpha) blendPixels(_strip1, _layers[i].color, _layers[i].alpha);
+    }
+    if (_brightness != 255) blendPixels(_strip1, Colors::BLACK, 255 - _brightness);
+    if (_outputMode == LEDOutputMode::INDEPENDENT) {
+        memcpy(_strip2.getPixels(), _strip1.getPixels(), _numPixels * 3);
+    }
+    uint32_t took = micros() - start;
+    
+    if (took > _effectMaxUs) _effectMaxUs = took > 0xFFFF ? 0xFFFF : took;
+    if (took > LED_EFFECT_BUDGET_US) {
+        if (_effectOverruns == 0) {
+            DEBUG_PRINT(F("LED effect over frame budget: "));
+            DEBUG_PRINT(took);
+            DEBUG_PRINTLN(F(" us"));
         }
-        
-        // Breathe out
-        for (int16_t i = 255; i >= 0; i -= 5) {
-            uint8_t r = (color.r * i) / 255;
-            uint8_t g = (color.g * i) / 255;
-            uint8_t b = (color.b * i) / 255;
-            setColor(r, g, b);
-            delay(10);
+        if (_effectOverruns < 0xFFFF) _effectOverruns++;
+    }
+    
+    _effectElapsed = elapsed;
+    _perPixel = true;
+    _framesRequested++;
+    _dirty = LED_DIRTY_ALL;
+}
+
+void LEDController::_fill(Adafruit_NeoPixel& strip, RGBColor base) {
+    RGBColor color = _compose(base);
+    if (_brightness != 255) color = scaleColor(color, ((uint16_t)_brightness << 8) | _brightness);
+    strip.fill(strip.Color(color.r, color.g, color.b));
+}
+
+RGBColor LEDController::_compose(RGBColor color) const {
+    // Bottom to top: each layer covers what is below by its alpha
+    for (uint8_t i = 0; i < LED_OVERLAY_LAYERS; i++) {
+        uint8_t alpha = _layers[i].alpha;
+        if (alpha) {
+            color = lerpColor(color, _layers[i].color, ((uint16_t)alpha << 8) | alpha);
         }
-        
-        delay(200);  // Pause between breaths
     }
+    return color;
 }
 
-void LEDController::setBrightness(uint8_t brightness) {
-    _strip1.setBrightness(brightness);
-    _strip2.setBrightness(brightness);
-    _update();
+void LEDController::_recompose() {
+    if (_perPixel) {
+        _renderEffect(_effectElapsed);
+        return;
+    }
+    _fill(_strip1, _currentColor);
+    if (_outputMode == LEDOutputMode::INDEPENDENT) _fill(_strip2, _rightColor);
+    _framesRequested++;
+    _dirty = LED_DIRTY_ALL;
 }
 
-void LEDController::_update() {
-    _strip1.show();
-    _strip2.show();
+void LEDController::_updateFlash(uint32_t now) {
+    if (_flashToggles == 0 || (int32_t)(now - _flashNext) < 0) return;
+    
+    // An odd number of toggles left means the flash is on
+    _flashToggles--;
+    bool on = _flashToggles & 1;
+    _flashNext += on ? _flashOnMs : _flashOffMs;
+    _layers[LED_LAYER_NOTIFY].alpha = on ? _flashAlpha : 0;
+    _recompose();
 }
 
-RGBColor LEDController::_wheel(uint8_t hue) {
-    if (hue < 85) {
-        return RGBColor(hue * 3, 255 - hue * 3, 0);
-    } else if (hue < 170) {
-        hue -= 85;
-        return RGBColor(255 - hue * 3, 0, hue * 3);
-    } else {
-        hue -= 170;
-        return RGBColor(0, hue * 3, 255 - hue * 3);
+void LEDController::_loadKeyframe() {
+    const LEDKeyframe* key = &_timeline[_timelineIndex++];
+    uint8_t fadeTicks = pgm_read_byte(&key->fadeTicks);
+    uint8_t holdTicks = pgm_read_byte(&key->holdTicks);
+    
+    // Each keyframe starts exactly where the previous one ended
+    _animFrom = _animTo;
+    _animTo = readColor(&key->color);
+    _animEasing = (Easing)pgm_read_byte(&key->easing);
+    _keyFadeMs = (uint16_t)fadeTicks * LED_TIMELINE_TICK_MS;
+    _animRate = progressRate(_keyFadeMs);
+    _animDuration = _keyFadeMs + (uint16_t)holdTicks * LED_TIMELINE_TICK_MS;
+}
+
+void LEDController::_startAnimation(LEDAnimation animation, uint32_t duration) {
+#if SBOT_LED_DITHER
+    // The new animation decides whether its frames need dithering
+    _dithering = false;
+#endif
+    _animation = animation;
+    _animStart = millis();
+    _animDuration = duration;
+}
+
+void LEDController::_runToCompletion() {
+    // Keep going until the final frame has been pushed as well
+    while (update(millis()) || _dirty) {
+        delay(1);
     }
 }
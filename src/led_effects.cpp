@@ -0,0 +1,170 @@
+/**
+ * @file led_effects.cpp
+ * @brief Pixel shaders and the streaming effect renderer
+ * @version 1.0.0
+ */
+
+#include "led_effects.h"
+
+#define CHASE_SPACING_MASK  3       // Every 4th pixel lit
+
+// =============================================================================
+// PIXEL SHADERS
+// =============================================================================
+
+static RGBColor shadeChase(const PixelFrame& frame, uint16_t index) {
+    bool lit = ((index - frame.position) & CHASE_SPACING_MASK) == 0;
+    return lit ? frame.params->color : frame.params->background;
+}
+
+static RGBColor shadeComet(const PixelFrame& frame, uint16_t index) {
+    // Distance behind the head in 8.8 pixels, wrapping around the strip
+    int32_t behind = (int32_t)frame.position - ((int32_t)index << 8);
+    if (behind < 0) behind += (int32_t)frame.count << 8;
+    
+    uint32_t fade = ((uint32_t)behind * frame.step) >> 8;
+    if (fade >= COLOR_MATH_POSITION_MAX) return frame.params->background;
+    
+    uint16_t level = ease(Easing::GAMMA_IN, COLOR_MATH_POSITION_MAX - (uint16_t)fade);
+    return lerpColor(frame.params->background, frame.params->color, level);
+}
+
+static RGBColor shadeTwinkle(const PixelFrame& frame, uint16_t index) {
+    // Each pixel runs its own blink cycle, offset by a fixed hash of its
+    // index, and is only lit in a random share of those cycles
+    uint32_t phase = frame.phase + (uint16_t)(index * 40503U);
+    uint16_t cycle = phase >> 16;
+    
+    uint16_t hash = index * 0x9E37U + cycle * 0x79B9U;
+    hash ^= hash >> 7;
+    hash *= 0x2B5BU;
+    if ((uint8_t)(hash >> 8) >= frame.params->level) return frame.params->background;
+    
+    uint16_t level = ease(Easing::SINE_BREATH, (uint16_t)phase);
+    return lerpColor(frame.params->background, frame.params->color, level);
+}
+
+static RGBColor shadeGradient(const PixelFrame& frame, uint16_t index) {
+    // Triangle wave, so the scrolling gradient has no seam
+    uint16_t p = index * frame.step + frame.position;
+    uint16_t blend = p < 0x8000 ? p << 1 : (uint16_t)(0xFFFF - p) << 1;
+    return lerpColor(frame.params->color, frame.params->background, blend);
+}
+
+static RGBColor shadeVuBar(const PixelFrame& frame, uint16_t index) {
+    uint32_t bottom = (uint32_t)index << 8;
+    if (bottom + 256 <= frame.position) return frame.params->color;
+    if (bottom >= frame.position) return frame.params->background;
+    
+    // Top pixel: partly lit by the fraction of the level it covers
+    uint8_t fraction = frame.position - bottom;
+    return lerpColor(frame.params->background, frame.params->color,
+                     ((uint16_t)fraction << 8) | fraction);
+}
+
+static RGBColor shadeRainbow(const PixelFrame& frame, uint16_t index) {
+    uint16_t hue = index * frame.step + frame.position;
+    return hsvToRgb(hue >> 8, 255, frame.params->level);
+}
+
+// =============================================================================
+// RENDERER
+// =============================================================================
+
+/**
+ * @brief Stream one shader over the strip
+ * 
+ * A template, so each shader is inlined into its own loop instead of
+ * being called through a pointer for every pixel.
+ */
+template <RGBColor (*Shade)(const PixelFrame&, uint16_t)>
+static void renderPixels(const PixelFrame& frame, Adafruit_NeoPixel& strip) {
+    for (uint16_t i = 0; i < frame.count; i++) {
+        RGBColor c = Shade(frame, i);
+        strip.setPixelColor(i, c.r, c.g, c.b);
+    }
+}
+
+void renderEffect(LEDEffect effect, const LEDEffectParams& params,
+                  uint32_t timeMs, Adafruit_NeoPixel& strip) {
+    PixelFrame frame;
+    frame.params = &params;
+    frame.count = strip.numPixels();
+    frame.timeMs = timeMs;
+    frame.phase = 0;
+    frame.position = 0;
+    frame.step = 0;
+    if (frame.count == 0) return;
+    
+    // Per-frame setup: every division happens here, once
+    switch (effect) {
+        case LEDEffect::CHASE:
+            frame.position = (uint16_t)(timeMs * params.speed / 1000);
+            renderPixels<shadeChase>(frame, strip);
+            break;
+            
+        case LEDEffect::COMET: {
+            uint8_t speed = params.speed > 0 ? params.speed : 1;
+            uint8_t tail = params.level > 0 ? params.level : 1;
+            uint32_t lapMs = (uint32_t)frame.count * 1000 / speed;
+            uint32_t t = lapMs > 0 ? timeMs % lapMs : 0;
+            frame.position = (uint16_t)(((t * speed) << 8) / 1000);
+            frame.step = (uint16_t)(0xFFFFFFUL / ((uint32_t)tail << 8));
+            renderPixels<shadeComet>(frame, strip);
+            break;
+        }
+            
+        case LEDEffect::TWINKLE:
+            frame.phase = timeMs * params.speed;
+            renderPixels<shadeTwinkle>(frame, strip);
+            break;
+            
+        case LEDEffect::GRADIENT:
+            frame.position = (uint16_t)(timeMs * params.speed);
+            frame.step = 0xFFFF / frame.count;
+            renderPixels<shadeGradient>(frame, strip);
+            break;
+            
+        case LEDEffect::VU_BAR:
+            // 255 fills the whole bar
+            frame.position = (uint16_t)((params.level + (params.level >> 7)) * frame.count);
+            renderPixels<shadeVuBar>(frame, strip);
+            break;
+            
+        case LEDEffect::RAINBOW:
+            // 8.8 hue; one whole wheel along the strip. Whole seconds and
+            // the rest apart, so the product stays in range however long
+            // the effect runs
+            frame.position = (uint16_t)(((timeMs / 1000) * params.speed << 8) +
+                                        (((timeMs % 1000) * params.speed << 8) / 1000));
+            frame.step = 0xFFFF / frame.count;
+            renderPixels<shadeRainbow>(frame, strip);
+            break;
+    }
+}
+
+void blendPixels(Adafruit_NeoPixel& strip, RGBColor color, uint8_t alpha) {
+    // Scale the color as setPixelColor() would (0 means full brightness)
+    uint8_t brightness = strip.getBrightness() + 1;
+    if (brightness) {
+        color = RGBColor((color.r * brightness) >> 8,
+                         (color.g * brightness) >> 8,
+                         (color.b * brightness) >> 8);
+    }
+    
+    // Weights 0..256 so alpha 255 fully covers the pixels
+    uint16_t a = alpha + (alpha >> 7);
+    uint16_t keep = 256 - a;
+    uint16_t g = color.g * a;
+    uint16_t r = color.r * a;
+    uint16_t b = color.b * a;
+    
+    uint8_t* p = strip.getPixels();
+    uint8_t* end = p + strip.numPixels() * 3;
+    while (p < end) {
+        p[0] = (p[0] * keep + g) >> 8;
+        p[1] = (p[1] * keep + r) >> 8;
+        p[2] = (p[2] * keep + b) >> 8;
+        p += 3;
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @file light_shows.cpp
+ * @brief PROGMEM keyframe timelines for SBot light shows
+ * @version 1.0.0
+ */
+
+#include "light_shows.h"
+
+static_assert(sizeof(LEDKeyframe) == 6, "LEDKeyframe should pack into 6 bytes");
+
+const LEDKeyframe FLAME_SEQUENCE[] PROGMEM = {
+    LED_KEYFRAME(Colors::RED,       0,   0, Easing::LINEAR),
+    LED_KEYFRAME(Colors::ORANGE,  260,   0, Easing::LINEAR),
+    LED_KEYFRAME(Colors::YELLOW,  520,   0, Easing::LINEAR),
+    LED_KEYFRAME(Colors::MAGENTA, 520,   0, Easing::LINEAR)
+};
+static_assert(sizeof(FLAME_SEQUENCE) / sizeof(LEDKeyframe) == FLAME_SEQUENCE_LENGTH,
+              "FLAME_SEQUENCE_LENGTH out of date");
+
+const LEDKeyframe DOPE_SEQUENCE[] PROGMEM = {
+    LED_KEYFRAME(Colors::RED,     260,   0, Easing::LINEAR),
+    LED_KEYFRAME(Colors::ORANGE,  520,   0, Easing::LINEAR),
+    LED_KEYFRAME(Colors::YELLOW,  520, 100, Easing::LINEAR),
+    LED_KEYFRAME(Colors::MAGENTA, 520,   0, Easing::LINEAR)
+};
+static_assert(sizeof(DOPE_SEQUENCE) / sizeof(LEDKeyframe) == DOPE_SEQUENCE_LENGTH,
+              "DOPE_SEQUENCE_LENGTH out of date");
+
+const LEDKeyframe STARTUP_SEQUENCE[] PROGMEM = {
+    LED_KEYFRAME(Colors::RED,     260,   0, Easing::LINEAR),
+    LED_KEYFRAME(Colors::ORANGE,  520,   0, Easing::LINEAR),
+    LED_KEYFRAME(Colors::YELLOW,  520, 200, Easing::LINEAR),
+    LED_KEYFRAME(Colors::MAGENTA, 520,   0, Easing::LINEAR)
+};
+static_assert(sizeof(STARTUP_SEQUENCE) / sizeof(LEDKeyframe) == STARTUP_SEQUENCE_LENGTH,
+              "STARTUP_SEQUENCE_LENGTH out of date");
@@ -30,7 +30,15 @@
 #include "DFRobot_DF2301Q.h"
 #endif
 
-#include "melodies.h"
+#include "config.h"
+#include "colors.h"
+#include "light_shows.h"
+#include "led_controller.h"
+#include "servo_controller.h"
+#include "ambient_light.h"
+#include "command_parser.h"
+#include "scheduler.h"
+#include "melodies_compiled.h"
 
 // =============================================================================
 // PIN DEFINITIONS
@@ -42,73 +50,93 @@
 #define RightFoot   5
 #define PIN_AL      6   // Left Arm
 #define PIN_AR      7   // Right Arm
-#define PIN_LED_1   9   // NeoPixel Strip 1
-#define PIN_LED_2   10  // NeoPixel Strip 2
 #define Buzzer      13
-#define NUM_PIXELS  7
 
 // =============================================================================
 // GLOBAL OBJECTS
 // =============================================================================
 
-Otto Otto;
-Servo AL, AR;
+// Legs on channels 0-3, arms on ARM_CHANNEL_LEFT/RIGHT
+MotionController motion;
+Otto Otto(motion);
+ArmController arms(motion, PIN_AL, PIN_AR);
 
-Adafruit_NeoPixel strip1(NUM_PIXELS, PIN_LED_1, NEO_GRB + NEO_KHZ800);
-Adafruit_NeoPixel strip2(NUM_PIXELS, PIN_LED_2, NEO_GRB + NEO_KHZ800);
+LEDController leds(PIN_NEOPIXEL_1, PIN_NEOPIXEL_2, NUM_PIXELS);
 
 #ifdef SBOT_MODE_VOICE
 DFRobot_DF2301Q_I2C asr;
 #endif
 
-// Color array for crossfades
-int colors[][3] = {
-    {255, 0, 255},  // Magenta (Start)
-    {64, 0, 64},    // Magenta (Chill)
-    {255, 0, 0},    // Red
-    {255, 127, 0},  // Orange
-    {255, 255, 0}   // Yellow
+CommandParser commands;
+RtttlPlayer melodyPlayer;
+
+#if ENABLE_AUTO_DIM
+AmbientLight ambient(PIN_LIGHT_SENSOR);
+#endif
+
+// Scheduler task bodies (defined below)
+void taskSerial(uint32_t now);
+#ifdef SBOT_MODE_VOICE
+void taskVoice(uint32_t now);
+#endif
+void taskLeds(uint32_t now);
+void taskServos(uint32_t now);
+void taskAudio(uint32_t now);
+#if ENABLE_AUTO_DIM
+void taskLight(uint32_t now);
+#endif
+
+static const char TASK_NAME_SERIAL[] PROGMEM = "serial";
+#ifdef SBOT_MODE_VOICE
+static const char TASK_NAME_VOICE[]  PROGMEM = "voice";
+#endif
+static const char TASK_NAME_LEDS[]   PROGMEM = "leds";
+static const char TASK_NAME_SERVOS[] PROGMEM = "servos";
+static const char TASK_NAME_AUDIO[]  PROGMEM = "audio";
+#if ENABLE_AUTO_DIM
+static const char TASK_NAME_LIGHT[]  PROGMEM = "light";
+#endif
+
+Task tasks[] = {
+    { TASK_NAME_SERIAL, taskSerial, TASK_PERIOD_SERIAL, TASK_DEADLINE_SLACK, 0, 0, 0, 0 },
+    #ifdef SBOT_MODE_VOICE
+    { TASK_NAME_VOICE,  taskVoice,  TASK_PERIOD_VOICE,  TASK_DEADLINE_SLACK, 0, 0, 0, 0 },
+    #endif
+    { TASK_NAME_LEDS,   taskLeds,   TASK_PERIOD_LEDS,   TASK_DEADLINE_SLACK, 0, 0, 0, 0 },
+    { TASK_NAME_SERVOS, taskServos, TASK_PERIOD_SERVOS, TASK_DEADLINE_SLACK, 0, 0, 0, 0 },
+    { TASK_NAME_AUDIO,  taskAudio,  TASK_PERIOD_AUDIO,  TASK_DEADLINE_SLACK, 0, 0, 0, 0 },
+    #if ENABLE_AUTO_DIM
+    { TASK_NAME_LIGHT,  taskLight,  TASK_PERIOD_LIGHT,  TASK_DEADLINE_SLACK, 0, 0, 0, 0 },
+    #endif
 };
 
+Scheduler scheduler(tasks, sizeof(tasks) / sizeof(Task));
+
 // =============================================================================
 // LED FUNCTIONS
 // =============================================================================
 
 void setAllPixels(int r, int g, int b) {
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        strip1.setPixelColor(i, strip1.Color(r, g, b));
-        strip2.setPixelColor(i, strip2.Color(r, g, b));
-    }
-    strip1.show();
-    strip2.show();
-}
-
-void smoothCrossfade(int color1[3], int color2[3], int speed) {
-    for (int i = 0; i <= 255; i += 5) {
-        int r = map(i, 0, 255, color1[0], color2[0]);
-        int g = map(i, 0, 255, color1[1], color2[1]);
-        int b = map(i, 0, 255, color1[2], color2[2]);
-        setAllPixels(r, g, b);
-        delay(speed);
-    }
+    leds.setColor(r, g, b);
 }
 
 void fadeInMagenta() {
-    for (int i = 0; i <= 255; i += 5) {
-        for (int j = 0; j < NUM_PIXELS; j++) {
-            strip1.setPixelColor(j, strip1.Color((255 * i) / 255, 0, (255 * i) / 255));
-            strip2.setPixelColor(j, strip2.Color((255 * i) / 255, 0, (255 * i) / 255));
-        }
-        strip1.show();
-        strip2.show();
-        delay(10);
-    }
+    leds.fadeIn(Colors::MAGENTA, 520);
 }
 
 void fadeToHalfMagentaBlue() {
-    for (int i = 255; i >= 128; i -= 5) {
-        setAllPixels(i, 0, i / 2);
-        delay(20);
+    leds.crossfade(RGBColor(255, 0, 127), RGBColor(130, 0, 65), 10);
+}
+
+/**
+ * @brief Flash over the current light show to acknowledge a command
+ * @param accepted false for a command that was not understood
+ */
+void acknowledgeCommand(bool accepted) {
+    if (accepted) {
+        leds.flash(Colors::WHITE, 1, LED_ACK_FLASH_MS, 0, LED_ACK_ALPHA);
+    } else {
+        leds.flash(Colors::RED, 2, LED_ACK_FLASH_MS, LED_ACK_FLASH_MS, LED_ACK_ALPHA);
     }
 }
 
@@ -116,16 +144,30 @@ void fadeToHalfMagentaBlue() {
 // ARM FUNCTIONS
 // =============================================================================
 
+// The arms move in the background, so the legs can dance meanwhile
+
 void raiseArms() {
-    AL.write(130);
-    AR.write(60);
-    delay(500);
+    arms.moveTo(ARM_LEFT_RAISED, ARM_RIGHT_RAISED);
 }
 
 void lowerArms() {
-    AL.write(0);
-    AR.write(190);
-    delay(500);
+    arms.moveTo(ARM_LEFT_HOME, ARM_RIGHT_HOME);
+}
+
+// =============================================================================
+// AUDIO FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Wait for the background melody to finish
+ * 
+ * delay() keeps calling yield(), so LEDs, queued leg poses and the
+ * melody itself all keep advancing while we wait.
+ */
+void waitForMelody() {
+    while (melodyPlayer.isPlaying()) {
+        delay(1);
+    }
 }
 
 // =============================================================================
@@ -137,29 +179,28 @@ void lowerArms() {
  * Triggered by voice command (CMDID 5) or serial "dope"
  */
 void dopeState() {
+    scheduler.markLongRun();
     Serial.println(F("🔥 Running Dope State..."));
 
+    // Arms go up during the victory swing and down during the flame
     fadeInMagenta();
     Otto.sing(S_superHappy);
     raiseArms();
     Otto.playGesture(OttoVictory);
     lowerArms();
+    leds.playTimeline(FLAME_SEQUENCE, FLAME_SEQUENCE_LENGTH);
 
-    for (int c = 2; c < 4; c++) {
-        smoothCrossfade(colors[c], colors[c + 1], (c == 2) ? 5 : 10);
-    }
-
-    setAllPixels(255, 255, 0);
-    smoothCrossfade(colors[4], colors[0], 10);
-    AL.write(AL.read() + 30);
-    AR.write(AR.read() - 30);
+    uint8_t left = arms.getLeftAngle() + 30;
+    uint8_t right = arms.getRightAngle() - 30;
+    arms.moveTo(left, right, ARM_SWAY_TIME);
     Otto.sing(S_happy);
+
+    // Della plays in the background while Otto bounces and the arms sway
+    melodyPlayer.startSong(Buzzer, SONG_DELLA);
+    arms.moveTo(left - 22, right + 22, 1500);
     Otto.updown(1, 1500, 20);
-    playRtttlBlockingPGM(Buzzer, (char*)MELODY_DELLA);
 
-    AL.write(AL.read() - 22);
-    AR.write(AR.read() + 22);
-    delay(500);
+    waitForMelody();
     raiseArms();
     Otto.playGesture(OttoFail);
     lowerArms();
@@ -172,18 +213,16 @@ void dopeState() {
  * Triggered by voice command (CMDID 6) or serial "chill"
  */
 void chillState() {
+    scheduler.markLongRun();
     Serial.println(F("🎵 Setting arms position..."));
-    AL.write(15);
-    AR.write(175);
+    arms.moveTo(15, 175);
 
     Serial.println(F("🎵 Playing S_cuddly..."));
     Otto.sing(S_cuddly);
 
+    // The fade keeps running through yield() while Otto dances
     Serial.println(F("💜 Fading to 25% Magenta..."));
-    for (int i = 0; i <= 64; i += 2) {
-        setAllPixels(i, 0, i);
-        delay(10);
-    }
+    leds.startFadeIn(Colors::MAGENTA_DIM, 330);
 
     Serial.println(F("🕺 Performing Crusaito Move..."));
     Otto.crusaito(2, 1500, 15, 1);
@@ -202,6 +241,7 @@ void chillState() {
  * Runs the complete animation automatically
  */
 void runFullStartupSequence() {
+    scheduler.markLongRun();
     Serial.println(F("🚀 Running Full Startup Sequence..."));
     
     // Fade in Magenta
@@ -211,23 +251,18 @@ void runFullStartupSequence() {
     Otto.playGesture(OttoVictory);
     lowerArms();
     
-    // Color crossfade sequence
-    for (int c = 2; c < 4; c++) {
-        int speed = (c == 2) ? 5 : 10;
-        smoothCrossfade(colors[c], colors[c + 1], speed);
-    }
+    // Color sequence: Red -> Orange -> Yellow, hold, back to Magenta
+    leds.playTimeline(FLAME_SEQUENCE, FLAME_SEQUENCE_LENGTH);
     
-    setAllPixels(255, 255, 0);
-    smoothCrossfade(colors[4], colors[0], 10);
-    
-    AL.write(AL.read() + 30);
-    AR.write(AR.read() - 30);
+    uint8_t left = arms.getLeftAngle() + 30;
+    uint8_t right = arms.getRightAngle() - 30;
+    arms.moveTo(left, right, ARM_SWAY_TIME);
+    melodyPlayer.startSong(Buzzer, SONG_DELLA);
+    arms.wait();
+    arms.moveTo(left - 22, right + 22, 1500);
     Otto.updown(1, 1500, 20);
-    playRtttlBlockingPGM(Buzzer, (char*)MELODY_DELLA);
 
-    AL.write(AL.read() - 22);
-    AR.write(AR.read() + 22);
-    delay(500);
+    waitForMelody();
     raiseArms();
     Otto.playGesture(OttoFail);
     fadeToHalfMagentaBlue();
@@ -275,20 +310,22 @@ void setup() {
     pinMode(Buzzer, OUTPUT);
 
     // Initialize NeoPixel strips
-    strip1.begin();
-    strip2.begin();
-    strip1.show();
-    strip2.show();
+    leds.begin();
+    #if ENABLE_AUTO_DIM
+    ambient.begin();
+    leds.setBrightness(ambient.getBrightness());
+    #endif
 
     // Initialize Otto
     Otto.init(LeftLeg, RightLeg, LeftFoot, RightFoot, true, Buzzer);
     Otto.home();
+    Otto.setBlend(ENABLE_MOTION_BLEND);
 
     // Initialize arm servos
-    AL.attach(PIN_AL);
-    AR.attach(PIN_AR);
-    AL.write(0);
-    AR.write(190);
+    arms.begin();
+
+    // Start background servo stepping (interrupt-driven with MOTION_USE_ISR)
+    motion.begin();
 
     Serial.println(F("✅ Hardware Ready!"));
 
@@ -304,25 +341,53 @@ void setup() {
     Serial.println(F("  Serial: Type 'dope' or 'chill'"));
     Serial.println(F(""));
     #endif
+
+    scheduler.begin();
 }
 
 // =============================================================================
-// MAIN LOOP
+// BACKGROUND SERVICE
 // =============================================================================
 
-void loop() {
+/**
+ * @brief Advance background animations, servo motion and melody
+ * 
+ * The Arduino core calls yield() while it spins inside delay(), so LED
+ * animations, queued leg poses and the background melody keep running
+ * during blocking servo moves and sounds.
+ */
+void yield() {
+    static bool busy = false;
+    if (busy) return;
     
-    // ===== VOICE COMMANDS (Voice mode only) =====
-    #ifdef SBOT_MODE_VOICE
+    busy = true;
+    unsigned long now = millis();
+    leds.update(now);
+    Otto.update(now);
+    melodyPlayer.update(now);
+    busy = false;
+}
+
+// =============================================================================
+// SCHEDULER TASKS
+// =============================================================================
+
+#ifdef SBOT_MODE_VOICE
+/**
+ * @brief Poll the voice module for a recognised command
+ */
+void taskVoice(uint32_t now) {
     uint8_t CMDID = asr.getCMDID();
     switch (CMDID) {
         case 5:
             Serial.println(F("🎤 CMDID 5 Received: Triggering Dope State!"));
+            acknowledgeCommand(true);
             dopeState();
             break;
 
         case 6:
             Serial.println(F("🎤 CMDID 6 Received: Triggering Chill State!"));
+            acknowledgeCommand(true);
             chillState();
             break;
 
@@ -333,45 +398,115 @@ void loop() {
             }
             break;
     }
-    #endif
+}
+#endif
 
-    // ===== SERIAL COMMANDS (Both modes) =====
-    if (Serial.available() > 0) {
-        String command = Serial.readStringUntil('\n');
-        command.trim();
+/**
+ * @brief Dispatch serial commands as soon as a line completes
+ */
+void taskSerial(uint32_t now) {
+    SerialCommand command = commands.poll(Serial);
+    if (command != SerialCommand::NONE) {
+        acknowledgeCommand(command != SerialCommand::UNKNOWN);
+    }
 
-        if (command.equalsIgnoreCase("dope")) {
+    switch (command) {
+        case SerialCommand::DOPE:
             Serial.println(F("🖥️ Serial Command: Triggering Dope State!"));
             dopeState();
-        }
-        else if (command.equalsIgnoreCase("chill")) {
+            break;
+
+        case SerialCommand::CHILL:
             Serial.println(F("🖥️ Serial Command: Triggering Chill State!"));
             chillState();
-        }
-        else if (command.equalsIgnoreCase("startup") || command.equalsIgnoreCase("demo")) {
+            break;
+
+        case SerialCommand::STARTUP:
             Serial.println(F("🖥️ Serial Command: Running Full Startup Sequence!"));
             runFullStartupSequence();
-        }
-        else if (command.equalsIgnoreCase("home")) {
+            break;
+
+        case SerialCommand::HOME:
             Serial.println(F("🖥️ Returning home..."));
+            lowerArms();
             Otto.home();
-            AL.write(0);
-            AR.write(190);
             setAllPixels(0, 0, 0);
-        }
-        else if (command.equalsIgnoreCase("help")) {
+            break;
+
+        case SerialCommand::HELP:
             Serial.println(F("\n--- Available Commands ---"));
             Serial.println(F("  dope    - Run Dope State"));
             Serial.println(F("  chill   - Run Chill State"));
             Serial.println(F("  startup - Run full startup sequence"));
             Serial.println(F("  home    - Return to home position"));
+            Serial.println(F("  stats   - Show task timing and LED frame statistics"));
             Serial.println(F("  help    - Show this menu"));
             Serial.println(F("--------------------------\n"));
-        }
-        else if (command.length() > 0) {
+            break;
+
+        case SerialCommand::STATS:
+            scheduler.printStats(Serial);
+            Serial.print(F("LED frames pushed/requested: "));
+            Serial.print(leds.getFramesPushed());
+            Serial.print('/');
+            Serial.println(leds.getFramesRequested());
+            Serial.print(F("LED servo-sync timeouts: "));
+            Serial.println(leds.getServoSyncMisses());
+            Serial.print(F("LED effect frame max: "));
+            Serial.print(leds.getEffectMaxUs());
+            Serial.print(F(" us, over budget: "));
+            Serial.println(leds.getEffectOverruns());
+            Serial.print(F("LED brightness: "));
+            Serial.println(leds.getBrightness());
+            #if ENABLE_AUTO_DIM
+            Serial.print(F("Ambient light level: "));
+            Serial.println(ambient.getLevel());
+            #endif
+            break;
+
+        case SerialCommand::UNKNOWN:
             Serial.println(F("❌ Unknown command. Type 'help' for options."));
-        }
+            break;
+
+        default:
+            break;
     }
+}
+
+/**
+ * @brief Advance LED animations
+ */
+void taskLeds(uint32_t now) {
+    leds.update(now);
+}
 
-    delay(300);
+/**
+ * @brief Advance queued leg poses and every servo move
+ */
+void taskServos(uint32_t now) {
+    Otto.update(now);
+}
+
+/**
+ * @brief Advance the background melody
+ */
+void taskAudio(uint32_t now) {
+    melodyPlayer.update(now);
+}
+
+#if ENABLE_AUTO_DIM
+/**
+ * @brief Follow the room light with the LED brightness
+ */
+void taskLight(uint32_t now) {
+    leds.setBrightness(ambient.sample());
+}
+#endif
+
+// =============================================================================
+// MAIN LOOP
+// =============================================================================
+
+void loop() {
+    scheduler.run();
 }
@@ -0,0 +1,52 @@
+/**
+ * @file melodies_compiled.cpp
+ * @brief Note streams declared in melodies_compiled.h
+ * @version 1.0.0
+ * 
+ * GENERATED by tools/rtttl_compile.py - do not edit by hand.
+ */
+
+#include "melodies_compiled.h"
+
+// MELODY_DELLA: 62 notes, 124 bytes, 29280 ms
+const uint16_t SONG_DELLA_NOTES[] PROGMEM = {
+    0x01CC, 0x01D1, 0x01D3, 0x0153, 0x01D0, 0x0158, 0x0157, 0x0158,
+    0x015A, 0x01DC, 0x0058, 0x01D0, 0x01D0, 0x01D0, 0x01D7, 0x01D8,
+    0x0563, 0x01D8, 0x0058, 0x01D0, 0x01D0, 0x01D8, 0x01D8, 0x00D8,
+    0x01D0, 0x01DA, 0x01D8, 0x0057, 0x01D0, 0x054C, 0x01D0, 0x01CC,
+    0x01CA, 0x01C8, 0x00D3, 0x01D0, 0x0158, 0x015A, 0x0561, 0x01DC,
+    0x04DC, 0x01D0, 0x01D0, 0x0163, 0x0161, 0x01DC, 0x01E1, 0x01DC,
+    0x0158, 0x0553, 0x01D0, 0x01DA, 0x01D8, 0x01D7, 0x01D5, 0x0157,
+    0x01D0, 0x0158, 0x01D0, 0x0158, 0x01D0, 0x0058,
+};
+
+// MELODY_STARTUP: 4 notes, 8 bytes, 415 ms
+const uint16_t SONG_STARTUP_NOTES[] PROGMEM = {
+    0x0251, 0x0255, 0x0258, 0x01E1,
+};
+
+// MELODY_SUCCESS: 4 notes, 8 bytes, 750 ms
+const uint16_t SONG_SUCCESS_NOTES[] PROGMEM = {
+    0x01D1, 0x01D5, 0x01D8, 0x0161,
+};
+
+// MELODY_ERROR: 5 notes, 10 bytes, 1250 ms
+const uint16_t SONG_ERROR_NOTES[] PROGMEM = {
+    0x01C1, 0x01C0, 0x01C1, 0x01C0, 0x01C1,
+};
+
+// MELODY_ALERT: 7 notes, 14 bytes, 750 ms
+const uint16_t SONG_ALERT_NOTES[] PROGMEM = {
+    0x0258, 0x0250, 0x0258, 0x0250, 0x0258, 0x0250, 0x0158,
+};
+
+// MELODY_HAPPY: 11 notes, 22 bytes, 2621 ms
+const uint16_t SONG_HAPPY_NOTES[] PROGMEM = {
+    0x01D1, 0x01D3, 0x01D5, 0x01D6, 0x0158, 0x0158, 0x01DA, 0x01DA,
+    0x01DA, 0x01DA, 0x0158,
+};
+
+// MELODY_SLEEP: 4 notes, 8 bytes, 3750 ms
+const uint16_t SONG_SLEEP_NOTES[] PROGMEM = {
+    0x0141, 0x0145, 0x0148, 0x00D1,
+};
@@ -0,0 +1,98 @@
+/**
+ * @file scheduler.cpp
+ * @brief Implementation of the cooperative task scheduler
+ * @version 1.0.0
+ */
+
+#include "scheduler.h"
+
+Scheduler::Scheduler(Task* tasks, uint8_t count)
+    : _tasks(tasks)
+    , _count(count)
+    , _running(false)
+    , _longRun(false)
+    , _longRuns(0) {
+}
+
+void Scheduler::begin() {
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < _count; i++) {
+        _tasks[i].nextRun = now;
+    }
+    resetStats();
+}
+
+void Scheduler::run() {
+    for (uint8_t i = 0; i < _count; i++) {
+        Task& task = _tasks[i];
+        uint32_t now = millis();
+        
+        // Signed difference keeps this correct across millis() rollover
+        int32_t lateness = (int32_t)(now - task.nextRun);
+        if (lateness < 0) continue;
+        
+        if ((uint32_t)lateness > task.deadlineMs && task.missed < 0xFFFF) {
+            task.missed++;
+        }
+        
+        uint32_t start = micros();
+        _running = true;
+        _longRun = false;
+        task.run(now);
+        _running = false;
+        uint32_t elapsed = micros() - start;
+        
+        if (_longRun) {
+            // Everything else was held up on purpose; start afresh
+            // instead of counting a miss for each task
+            uint32_t after = millis();
+            for (uint8_t j = 0; j < _count; j++) {
+                if (j != i) _tasks[j].nextRun = after;
+            }
+            if (_longRuns < 0xFFFF) _longRuns++;
+        } else if (elapsed > task.maxRunUs) {
+            task.maxRunUs = elapsed;
+        }
+        if (task.runs < 0xFFFF) task.runs++;
+        
+        // Stay on the period grid, but never try to catch up a backlog
+        task.nextRun += task.periodMs;
+        if ((int32_t)(millis() - task.nextRun) >= 0) {
+            task.nextRun = millis() + task.periodMs;
+        }
+    }
+}
+
+void Scheduler::markLongRun() {
+    if (_running) _longRun = true;
+}
+
+void Scheduler::printStats(Print& out) const {
+    out.println(F("\n--- Task Stats ---"));
+    out.println(F("  task     period  max_us  runs  missed"));
+    for (uint8_t i = 0; i < _count; i++) {
+        const Task& task = _tasks[i];
+        out.print(F("  "));
+        out.print(reinterpret_cast<const __FlashStringHelper*>(task.name));
+        for (uint8_t pad = strlen_P(task.name); pad < 9; pad++) out.print(' ');
+        out.print(task.periodMs);
+        out.print(F("ms\t"));
+        out.print(task.maxRunUs);
+        out.print('\t');
+        out.print(task.runs);
+        out.print('\t');
+        out.println(task.missed);
+    }
+    out.print(F("  long runs (states): "));
+    out.println(_longRuns);
+    out.println(F("------------------\n"));
+}
+
+void Scheduler::resetStats() {
+    for (uint8_t i = 0; i < _count; i++) {
+        _tasks[i].maxRunUs = 0;
+        _tasks[i].runs = 0;
+        _tasks[i].missed = 0;
+    }
+    _longRuns = 0;
+}
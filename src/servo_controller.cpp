@@ -7,34 +7,37 @@
 #include "servo_controller.h"
 #include <Arduino.h>
 
-ArmController::ArmController(uint8_t leftPin, uint8_t rightPin)
-    : _leftPin(leftPin)
-    , _rightPin(rightPin)
-    , _leftAngle(ARM_LEFT_HOME)
-    , _rightAngle(ARM_RIGHT_HOME) {
+ArmController::ArmController(MotionController& motion, uint8_t leftPin, uint8_t rightPin)
+    : _motion(motion)
+    , _leftPin(leftPin)
+    , _rightPin(rightPin) {
 }
 
 void ArmController::begin() {
-    _leftArm.attach(_leftPin);
-    _rightArm.attach(_rightPin);
-    home();
+    _motion.attach(ARM_CHANNEL_LEFT, _leftPin);
+    _motion.attach(ARM_CHANNEL_RIGHT, _rightPin);
+    setPosition(ARM_LEFT_HOME, ARM_RIGHT_HOME);
+    
+    _motion.setPlanner(ARM_CHANNEL_LEFT, &_leftPlan);
+    _motion.setPlanner(ARM_CHANNEL_RIGHT, &_rightPlan);
+    _setLimits(ARM_MAX_SPEED);
     
     DEBUG_PRINTLN(F("Arm Controller initialized"));
 }
 
 void ArmController::detach() {
-    _leftArm.detach();
-    _rightArm.detach();
+    _motion.detach(ARM_CHANNEL_LEFT);
+    _motion.detach(ARM_CHANNEL_RIGHT);
 }
 
 void ArmController::home() {
-    setPosition(ARM_LEFT_HOME, ARM_RIGHT_HOME);
-    delay(SERVO_MOVE_DELAY);
+    moveTo(ARM_LEFT_HOME, ARM_RIGHT_HOME);
+    wait();
 }
 
 void ArmController::raise() {
-    setPosition(ARM_LEFT_RAISED, ARM_RIGHT_RAISED);
-    delay(SERVO_MOVE_DELAY);
+    moveTo(ARM_LEFT_RAISED, ARM_RIGHT_RAISED);
+    wait();
 }
 
 void ArmController::lower() {
@@ -42,13 +45,11 @@ void ArmController::lower() {
 }
 
 void ArmController::setLeft(uint8_t angle) {
-    _leftAngle = constrain(angle, 0, 180);
-    _leftArm.write(_leftAngle);
+    _motion.write(ARM_CHANNEL_LEFT, angle);
 }
 
 void ArmController::setRight(uint8_t angle) {
-    _rightAngle = constrain(angle, 0, 180);
-    _rightArm.write(_rightAngle);
+    _motion.write(ARM_CHANNEL_RIGHT, angle);
 }
 
 void ArmController::setPosition(uint8_t leftAngle, uint8_t rightAngle) {
@@ -56,36 +57,40 @@ void ArmController::setPosition(uint8_t leftAngle, uint8_t rightAngle) {
     setRight(rightAngle);
 }
 
+bool ArmController::moveTo(uint8_t leftAngle, uint8_t rightAngle) {
+    // Keep the arms in step: queue on both or on neither
+    if (!_motion.canPlan(ARM_CHANNEL_LEFT) || !_motion.canPlan(ARM_CHANNEL_RIGHT)) return false;
+    _motion.planTo(ARM_CHANNEL_LEFT, leftAngle);
+    _motion.planTo(ARM_CHANNEL_RIGHT, rightAngle);
+    return true;
+}
+
+void ArmController::moveTo(uint8_t leftAngle, uint8_t rightAngle, uint16_t duration) {
+    _motion.moveTo(ARM_CHANNEL_LEFT, leftAngle, duration);
+    _motion.moveTo(ARM_CHANNEL_RIGHT, rightAngle, duration);
+}
+
 void ArmController::smoothMove(uint8_t leftTarget, uint8_t rightTarget, uint8_t speed) {
-    // Calculate steps needed
-    int8_t leftDiff = leftTarget - _leftAngle;
-    int8_t rightDiff = rightTarget - _rightAngle;
-    int8_t maxSteps = max(abs(leftDiff), abs(rightDiff));
-    
-    if (maxSteps == 0) return;
-    
-    float leftStep = (float)leftDiff / maxSteps;
-    float rightStep = (float)rightDiff / maxSteps;
-    
-    float currentLeft = _leftAngle;
-    float currentRight = _rightAngle;
-    
-    for (int8_t i = 0; i < maxSteps; i++) {
-        currentLeft += leftStep;
-        currentRight += rightStep;
-        
-        setLeft((uint8_t)currentLeft);
-        setRight((uint8_t)currentRight);
-        delay(speed);
-    }
-    
-    // Ensure we reach exact target
-    setPosition(leftTarget, rightTarget);
+    // Cruise at one degree per `speed` ms, easing in and out
+    _setLimits(speed > 0 ? 1000 / speed : ARM_MAX_SPEED);
+    moveTo(leftTarget, rightTarget);
+    wait();
+    _setLimits(ARM_MAX_SPEED);
+}
+
+void ArmController::_setLimits(uint16_t maxSpeed) {
+    // Never above the joint limit, whatever speed the caller asked for
+    if (maxSpeed > ARM_MAX_SPEED) maxSpeed = ARM_MAX_SPEED;
+
+    // Through the controller, which may be stepping the planners from
+    // its interrupt
+    _motion.setLimits(ARM_CHANNEL_LEFT, maxSpeed, ARM_MAX_ACCEL);
+    _motion.setLimits(ARM_CHANNEL_RIGHT, maxSpeed, ARM_MAX_ACCEL);
 }
 
 void ArmController::wave(uint8_t waves) {
     // Raise right arm
-    smoothMove(_leftAngle, 90, 10);
+    smoothMove(getLeftAngle(), 90, 10);
     delay(200);
     
     // Wave motion
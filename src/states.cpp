@@ -8,11 +8,15 @@
 #include "led_controller.h"
 #include "servo_controller.h"
 #include "colors.h"
-#include "melodies.h"
+#include "light_shows.h"
+#include "melodies_compiled.h"
 #include "config.h"
 #include <Arduino.h>
 #include <PlayRtttl.hpp>
 
+// Fade to the idle color, as long as the old blocking crossfade at 15 ms a step
+#define IDLE_FADE_MS    (15 * LED_FADE_STEPS)
+
 // State name lookup table
 const char* getStateName(SBotState state) {
     switch (state) {
@@ -52,41 +56,35 @@ void StateManager::runStartup() {
     DEBUG_PRINTLN(F("🚀 Running Startup Sequence..."));
     
     // From 0002: Full initialization sequence
-    // 1. Fade in Magenta
-    _leds.fadeIn(Colors::MAGENTA, 500);
+    // 1. Fade in Magenta while the arms move to their lowered position
+    _leds.startFadeIn(Colors::MAGENTA, 500);
     
     // 2. Arms initialization - lower position first
     _arms.setPosition(15, 165);
-    delay(500);
+    _wait(500);
     
     // 3. Raise arms with victory gesture
     _arms.raise();
-    delay(300);
+    _wait(300);
     _arms.lower();
     
-    // 4. Color sequence: Red -> Orange -> Yellow
-    _leds.crossfade(Colors::MAGENTA, Colors::RED, 5);
-    _leds.crossfade(Colors::RED, Colors::ORANGE, 10);
-    _leds.crossfade(Colors::ORANGE, Colors::YELLOW, 10);
+    // 4-5. Color sequence: Red -> Orange -> Yellow, hold, back to Magenta
+    _leds.playTimeline(STARTUP_SEQUENCE, STARTUP_SEQUENCE_LENGTH);
     
-    // 5. Yellow hold then back to Magenta
-    _leds.setColor(Colors::YELLOW);
-    delay(200);
-    _leds.crossfade(Colors::YELLOW, Colors::MAGENTA, 10);
-    
-    // 6. Arm adjustment during melody
-    _arms.setPosition(_arms.getLeftAngle() + 30, _arms.getRightAngle() - 30);
-    
-    // 7. Play celebration melody (Della)
+    // 6. Start the celebration melody (Della) in the background
     #if ENABLE_SOUND_EFFECTS
-    playRtttlBlockingPGM(_buzzerPin, (char*)MELODY_DELLA);
+    _player.startSong(_buzzerPin, SONG_DELLA);
     #endif
     
-    // 8. Final arm adjustments
+    // 7. Arm adjustment during melody
+    _arms.setPosition(_arms.getLeftAngle() + 30, _arms.getRightAngle() - 30);
+    
+    // 8. Final arm adjustments once the melody ends
+    _waitForMelody();
     _arms.setPosition(_arms.getLeftAngle() - 22, _arms.getRightAngle() + 22);
-    delay(500);
+    _wait(500);
     _arms.raise();
-    delay(300);
+    _wait(300);
     
     // 9. Fade to half magenta-blue (chill indicator)
     _leds.crossfade(Colors::MAGENTA, RGBColor(128, 0, 64), 20);
@@ -107,35 +105,29 @@ void StateManager::runDopeState() {
     
     // 2. Raise arms with victory gesture
     _arms.raise();
-    delay(300);
+    _wait(300);
     _arms.lower();
     
-    // 3. Color crossfade sequence: Red -> Orange -> Yellow
-    _leds.crossfade(Colors::MAGENTA, Colors::RED, 5);
-    _leds.crossfade(Colors::RED, Colors::ORANGE, 10);
-    _leds.crossfade(Colors::ORANGE, Colors::YELLOW, 10);
+    // 3-4. Color sequence: Red -> Orange -> Yellow, hold, back to magenta
+    _leds.playTimeline(DOPE_SEQUENCE, DOPE_SEQUENCE_LENGTH);
     
-    // 4. Hold yellow then crossfade back to magenta
-    _leds.setColor(Colors::YELLOW);
-    delay(100);
-    _leds.crossfade(Colors::YELLOW, Colors::MAGENTA, 10);
-    
-    // 5. Arm movement during updown
-    _arms.setPosition(_arms.getLeftAngle() + 30, _arms.getRightAngle() - 30);
-    delay(300);
-    
-    // 6. Play the Della melody
+    // 5. Start the Della melody and move the arms while it plays
     #if ENABLE_SOUND_EFFECTS
-    playRtttlBlockingPGM(_buzzerPin, (char*)MELODY_DELLA);
+    _player.startSong(_buzzerPin, SONG_DELLA);
     #endif
+    _arms.setPosition(_arms.getLeftAngle() + 30, _arms.getRightAngle() - 30);
+    _wait(300);
     
-    // 7. Final arm adjustments
+    // 6. Final arm adjustments, still during the melody
     _arms.setPosition(_arms.getLeftAngle() - 22, _arms.getRightAngle() + 22);
-    delay(500);
+    _wait(500);
+    
+    // 7. Let the melody finish
+    _waitForMelody();
     
     // 8. Final raise/lower with fail gesture
     _arms.raise();
-    delay(300);
+    _wait(300);
     _arms.lower();
     
     DEBUG_PRINTLN(F("✅ Dope State Complete!"));
@@ -147,22 +139,18 @@ void StateManager::runChillState() {
     DEBUG_PRINTLN(F("😌 Running Chill State..."));
     
     // From 001: chillState() sequence
-    // 1. Set arms to relaxed position
+    // 1. Set arms to relaxed position while fading to 25% Magenta
     DEBUG_PRINTLN(F("🎵 Setting arms position..."));
     _arms.setPosition(15, 175);
-    delay(300);
     
-    // 2. Fade to 25% Magenta (64 out of 255)
     DEBUG_PRINTLN(F("💜 Fading to 25% Magenta..."));
-    for (int i = 0; i <= 64; i += 2) {
-        _leds.setColor(i, 0, i);  // Magenta fade (Red + Blue)
-        delay(10);
-    }
+    _leds.startFadeIn(Colors::MAGENTA_DIM, 330);
+    _wait(300);
     
-    // 3. Hold chill state
-    delay(500);
+    // 2. Hold chill state (the fade finishes during the hold)
+    _wait(500);
     
-    // 4. Return arms to home
+    // 3. Return arms to home
     DEBUG_PRINTLN(F("🏡 Returning Home..."));
     _arms.home();
     
@@ -174,27 +162,23 @@ void StateManager::runAlertState() {
     setState(SBotState::ALERT);
     DEBUG_PRINTLN(F("⚠️ Running Alert State..."));
     
-    // Flash orange for attention
-    for (uint8_t i = 0; i < 3; i++) {
-        _leds.setColor(Colors::ORANGE);
-        delay(200);
-        _leds.off();
-        delay(200);
-    }
-    
-    // Arms up
-    _arms.raise();
+    // Flash orange for attention, over whatever mood is showing
+    _leds.flash(Colors::ORANGE, 3, 200, 200);
+    _wait(3 * 400);
     
-    // Alert sound
+    // Alert sound while the arms go up
     #if ENABLE_SOUND_EFFECTS
-    playRtttlBlockingPGM(_buzzerPin, (char*)MELODY_ALERT);
+    _player.startSong(_buzzerPin, SONG_ALERT);
     #endif
+    _arms.raise();
     
     // Hold alert color
-    _leds.setColor(Colors::ORANGE);
-    delay(1000);
+    _leds.setLayer(LEDLayer::OVERLAY, Colors::ORANGE);
+    _wait(1000);
+    _waitForMelody();
     
     // Return to normal
+    _leds.clearLayer(LEDLayer::OVERLAY);
     _arms.lower();
     
     DEBUG_PRINTLN(F("✅ Alert State Complete!"));
@@ -202,8 +186,28 @@ void StateManager::runAlertState() {
 }
 
 void StateManager::returnToIdle() {
-    // Fade to idle color (dim white)
-    _leds.crossfade(_leds.getCurrentColor(), RGBColor(50, 50, 50), 15);
+    // Fade to idle color (dim white) in the background while arms go home
+    _leds.startCrossfade(_leds.getCurrentColor(), RGBColor(50, 50, 50), IDLE_FADE_MS);
     _arms.home();
     setState(SBotState::IDLE);
 }
+
+void StateManager::update(uint32_t now) {
+    _leds.update(now);
+    _player.update(now);
+}
+
+void StateManager::_waitForMelody() {
+    while (_player.isPlaying()) {
+        update(millis());
+        delay(1);
+    }
+}
+
+void StateManager::_wait(uint16_t ms) {
+    uint32_t start = millis();
+    while (millis() - start < ms) {
+        update(millis());
+        delay(1);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file test_main.cpp
+ * @brief Integer hsvToRgb() against a floating-point HSV reference
+ *
+ * Sweeps all 2^24 hue/saturation/value inputs and checks every channel
+ * against the textbook conversion with the same six 256-step sectors.
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include <unity.h>
+
+#include "color_math.h"
+
+#define MAX_ERROR_LSB   1.0
+
+static void referenceHsv(uint8_t hue, uint8_t saturation, uint8_t value, double rgb[3]) {
+    double h = hue * 6.0 / 256;
+    int sector = (int)h;
+    double f = h - sector;
+    double s = saturation / 255.0;
+    double v = value;
+
+    double p = v * (1 - s);
+    double q = v * (1 - s * f);
+    double t = v * (1 - s * (1 - f));
+
+    switch (sector) {
+        case 0:  rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+        case 1:  rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+        case 2:  rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+        case 3:  rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+        case 4:  rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+        default: rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_full_sweep_within_one_lsb(void) {
+    double maxError = 0;
+    double sum = 0;
+
+    for (uint16_t hue = 0; hue < 256; hue++) {
+        for (uint16_t saturation = 0; saturation < 256; saturation++) {
+            for (uint16_t value = 0; value < 256; value++) {
+                RGBColor color = hsvToRgb(hue, saturation, value);
+                double rgb[3];
+                referenceHsv(hue, saturation, value, rgb);
+
+                double error[3] = {
+                    fabs(color.r - rgb[0]), fabs(color.g - rgb[1]), fabs(color.b - rgb[2])
+                };
+                for (uint8_t i = 0; i < 3; i++) {
+                    if (error[i] > maxError) maxError = error[i];
+                    sum += error[i];
+                }
+            }
+        }
+    }
+
+    char message[64];
+    snprintf(message, sizeof(message), "max error %.3f LSB, mean %.3f LSB",
+             maxError, sum / (3.0 * 256 * 256 * 256));
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(MAX_ERROR_LSB, 0, maxError, message);
+}
+
+static void test_primaries_are_exact(void) {
+    RGBColor red = hsvToRgb(0);
+    TEST_ASSERT_EQUAL_UINT8(255, red.r);
+    TEST_ASSERT_EQUAL_UINT8(0, red.g);
+    TEST_ASSERT_EQUAL_UINT8(0, red.b);
+
+    // 256 / 3 is not whole, so green and blue sit just short of their
+    // sector start and one neighbour still glows a few LSB
+    RGBColor green = hsvToRgb(85);
+    TEST_ASSERT_EQUAL_UINT8(255, green.g);
+    TEST_ASSERT_EQUAL_UINT8(0, green.b);
+
+    RGBColor blue = hsvToRgb(170);
+    TEST_ASSERT_EQUAL_UINT8(255, blue.b);
+    TEST_ASSERT_EQUAL_UINT8(0, blue.r);
+}
+
+static void test_zero_saturation_is_gray(void) {
+    for (uint16_t hue = 0; hue < 256; hue += 17) {
+        RGBColor color = hsvToRgb(hue, 0, 200);
+        TEST_ASSERT_EQUAL_UINT8(200, color.r);
+        TEST_ASSERT_EQUAL_UINT8(200, color.g);
+        TEST_ASSERT_EQUAL_UINT8(200, color.b);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_sweep_within_one_lsb);
+    RUN_TEST(test_primaries_are_exact);
+    RUN_TEST(test_zero_saturation_is_gray);
+    return UNITY_END();
+}
@@ -0,0 +1,51 @@
+/**
+ * @file test_main.cpp
+ * @brief Per-pixel effects rendered into a strip buffer
+ *
+ * Checks that the rainbow hue keeps advancing steadily past the point
+ * where time * speed * 256 no longer fits in 32 bits.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "led_effects.h"
+#include "color_math.h"
+
+#define STRIP_PIXELS    8
+
+static Adafruit_NeoPixel strip(STRIP_PIXELS);
+
+static RGBColor pixel(uint16_t n) {
+    uint32_t c = strip.getPixelColor(n);
+    return RGBColor(c >> 16, c >> 8, c);
+}
+
+static void assertColor(RGBColor expected, RGBColor actual) {
+    TEST_ASSERT_EQUAL_UINT8(expected.r, actual.r);
+    TEST_ASSERT_EQUAL_UINT8(expected.g, actual.g);
+    TEST_ASSERT_EQUAL_UINT8(expected.b, actual.b);
+}
+
+void setUp(void) {
+    strip.clear();
+}
+
+void tearDown(void) {}
+
+static void test_rainbow_survives_product_overflow(void) {
+    LEDEffectParams params = { RGBColor(0, 0, 0), RGBColor(0, 0, 0), 255, 255 };
+
+    // 65794 * 255 * 256 is past 2^32; 2 ms later the hue must still be
+    // one step on, not wrapped back to the start of the wheel
+    renderEffect(LEDEffect::RAINBOW, params, 65792, strip);
+    assertColor(hsvToRgb(136, 255, 255), pixel(0));
+    renderEffect(LEDEffect::RAINBOW, params, 65794, strip);
+    assertColor(hsvToRgb(137, 255, 255), pixel(0));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rainbow_survives_product_overflow);
+    return UNITY_END();
+}
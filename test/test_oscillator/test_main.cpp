@@ -0,0 +1,90 @@
+/**
+ * @file test_main.cpp
+ * @brief Otto's fixed-point oscillator against the double sin()/round() reference
+ *
+ * Every 16-bit phase is pushed through Otto::_oscillate and the angle
+ * the MotionController lands on is compared with the floating-point
+ * formula the oscillator replaced.
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include <unity.h>
+
+#include <MotionController.h>
+#include <Otto.h>
+
+// The table sine is within 1.4e-4 of sin(), so at the largest amplitude
+// the unrounded angle may be off by 0.5 degree of rounding plus this
+#define MAX_ERROR_DEG   0.52
+
+class TestOtto : public Otto {
+public:
+    TestOtto(MotionController& motion) : Otto(motion) {}
+    using Otto::_oscillate;
+};
+
+static MotionController motion;
+static TestOtto otto(motion);
+
+static int oscillate(int A, int O, uint16_t phase) {
+    int amplitude[4] = { A, 0, 0, 0 };
+    int offset[4] = { O, 90, 90, 90 };
+    uint16_t phases[4] = { phase, 0, 0, 0 };
+    otto._oscillate(amplitude, offset, phases);
+    return motion.read(0);
+}
+
+static void checkAmplitude(int A, int O) {
+    double maxError = 0;
+    long maxRounded = 0;
+
+    for (uint32_t phase = 0; phase < 65536; phase++) {
+        double exact = O + A * sin(2 * M_PI * phase / 65536.0);
+        int angle = oscillate(A, O, (uint16_t)phase);
+
+        double error = fabs(angle - exact);
+        if (error > maxError) maxError = error;
+        long rounded = labs(angle - lround(exact));
+        if (rounded > maxRounded) maxRounded = rounded;
+    }
+
+    char message[64];
+    snprintf(message, sizeof(message), "A=%d O=%d: max error %.3f deg", A, O, maxError);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(MAX_ERROR_DEG, 0, maxError, message);
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(1, maxRounded, message);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_small_amplitudes(void) {
+    for (int A = 0; A <= 30; A++) checkAmplitude(A, 90);
+}
+
+static void test_dance_amplitudes(void) {
+    checkAmplitude(45, 90);
+    checkAmplitude(60, 90);
+    checkAmplitude(25, 70);
+}
+
+static void test_full_range(void) {
+    checkAmplitude(90, 90);
+}
+
+static void test_quadrant_peaks(void) {
+    TEST_ASSERT_EQUAL_INT(90, oscillate(60, 90, 0));
+    TEST_ASSERT_EQUAL_INT(150, oscillate(60, 90, 0x4000));
+    TEST_ASSERT_EQUAL_INT(90, oscillate(60, 90, 0x8000));
+    TEST_ASSERT_EQUAL_INT(30, oscillate(60, 90, 0xC000));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_small_amplitudes);
+    RUN_TEST(test_dance_amplitudes);
+    RUN_TEST(test_full_range);
+    RUN_TEST(test_quadrant_peaks);
+    return UNITY_END();
+}
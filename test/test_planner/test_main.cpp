@@ -0,0 +1,238 @@
+/**
+ * @file test_main.cpp
+ * @brief TrajectoryPlanner speed, acceleration, end point and blending checks
+ *
+ * Every tick's move (in 1/256 degree) is taken as the joint's velocity,
+ * and the change between two ticks as its acceleration. The arm case
+ * runs ArmController on the sim clock and reads its servo writes back.
+ */
+
+#include "sim_trace.h"    // Before Arduino.h, whose min/max break <vector>
+#include <Arduino.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include <MotionController.h>
+#include <TrajectoryPlanner.h>
+
+#include "servo_controller.h"
+
+#define MAX_TICKS   10000
+
+/**
+ * @brief What one run of the planner did
+ */
+struct Run {
+    uint16_t ticks;
+    int32_t maxSpeed;           // Largest move in one tick
+    int32_t maxAccel;           // Largest change of move between ticks
+    uint16_t stops;             // Ticks without motion before the end
+    bool passed[PLANNER_WAYPOINTS]; // Reached or driven through, in order
+    bool landed[PLANNER_WAYPOINTS]; // Stood exactly on it after a tick
+};
+
+// Limits in the planner's per-tick units, rounded like setLimits()
+static int32_t speedPerTick(uint16_t degPerSec) {
+    return ((uint32_t)degPerSec * 256 * MOTION_INTERVAL + 500) / 1000;
+}
+
+static int32_t accelPerTick(uint16_t degPerSec2) {
+    return ((uint32_t)degPerSec2 * 256 * MOTION_INTERVAL * MOTION_INTERVAL + 500000) / 1000000;
+}
+
+static Run runPlanner(TrajectoryPlanner& planner, const uint8_t* targets, uint8_t count) {
+    Run run = {};
+    int32_t last = planner.getPosition();
+    int32_t lastMove = 0;
+    int32_t from = last;
+    uint8_t next = 0;
+
+    while (planner.isMoving() && run.ticks < MAX_TICKS) {
+        planner.step();
+        run.ticks++;
+
+        int32_t position = planner.getPosition();
+        int32_t move = position - last;
+        int32_t accel = labs(move - lastMove);
+        if (labs(move) > run.maxSpeed) run.maxSpeed = labs(move);
+        if (accel > run.maxAccel) run.maxAccel = accel;
+        if (move == 0 && planner.isMoving()) run.stops++;
+
+        // Blended waypoints are driven through, so compare against the
+        // direction each one was approached from
+        while (next < count) {
+            int32_t point = (int32_t)targets[next] << 8;
+            if (point > from && position < point) break;
+            if (point < from && position > point) break;
+            run.passed[next] = true;
+            run.landed[next] = position == point;
+            from = point;
+            next++;
+        }
+        last = position;
+        lastMove = move;
+    }
+
+    // The stop after the last tick counts as a change of speed too
+    if (labs(lastMove) > run.maxAccel) run.maxAccel = labs(lastMove);
+    return run;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_single_moves_respect_limits(void) {
+    static const uint16_t speeds[] = { 30, 90, 360, 600 };
+    static const uint16_t accels[] = { 100, 900, 1800, 5000 };
+    static const uint8_t moves[][2] = { { 0, 180 }, { 180, 0 }, { 90, 93 }, { 45, 130 }, { 120, 119 } };
+
+    for (uint8_t s = 0; s < 4; s++) {
+        for (uint8_t a = 0; a < 4; a++) {
+            for (uint8_t m = 0; m < 5; m++) {
+                TrajectoryPlanner planner;
+                planner.setLimits(speeds[s], accels[a]);
+                planner.reset(moves[m][0]);
+                planner.push(moves[m][1]);
+
+                Run run = runPlanner(planner, &moves[m][1], 1);
+                TEST_ASSERT_FALSE(planner.isMoving());
+                TEST_ASSERT_LESS_OR_EQUAL(speedPerTick(speeds[s]), run.maxSpeed);
+                TEST_ASSERT_LESS_OR_EQUAL(accelPerTick(accels[a]), run.maxAccel);
+                TEST_ASSERT_EQUAL_UINT16((uint16_t)moves[m][1] << 8, planner.getPosition());
+                TEST_ASSERT_EQUAL(0, run.stops);
+            }
+        }
+    }
+}
+
+static void test_default_move_profile(void) {
+    TrajectoryPlanner planner;
+    planner.setLimits(360, 1800);
+    planner.reset(0);
+    planner.push(130);
+
+    static const uint8_t target = 130;
+    Run run = runPlanner(planner, &target, 1);
+
+    // Reaches cruise speed, and stops exactly on the target
+    TEST_ASSERT_EQUAL(speedPerTick(360), run.maxSpeed);
+    TEST_ASSERT_LESS_OR_EQUAL(accelPerTick(1800), run.maxAccel);
+    TEST_ASSERT_EQUAL_UINT16(130 << 8, planner.getPosition());
+    TEST_ASSERT_EQUAL_UINT8(130, planner.getAngle());
+    TEST_ASSERT_EQUAL_UINT16(0, planner.getSpeed());
+}
+
+static void test_same_direction_moves_blend(void) {
+    static const uint8_t targets[] = { 40, 80, 130 };
+
+    TrajectoryPlanner blended;
+    blended.setLimits(360, 1800);
+    blended.reset(0);
+    for (uint8_t i = 0; i < 3; i++) TEST_ASSERT_TRUE(blended.push(targets[i]));
+    Run run = runPlanner(blended, targets, 3);
+
+    // Passes through every waypoint without ever standing still
+    for (uint8_t i = 0; i < 3; i++) TEST_ASSERT_TRUE(run.passed[i]);
+    TEST_ASSERT_TRUE(run.landed[2]);
+    TEST_ASSERT_EQUAL(0, run.stops);
+    TEST_ASSERT_LESS_OR_EQUAL(speedPerTick(360), run.maxSpeed);
+    TEST_ASSERT_LESS_OR_EQUAL(accelPerTick(1800), run.maxAccel);
+    TEST_ASSERT_EQUAL_UINT16(130 << 8, blended.getPosition());
+
+    // The same moves one at a time stop at each waypoint and take longer
+    TrajectoryPlanner stepped;
+    stepped.setLimits(360, 1800);
+    stepped.reset(0);
+    uint16_t steppedTicks = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        stepped.push(targets[i]);
+        steppedTicks += runPlanner(stepped, &targets[i], 1).ticks;
+        TEST_ASSERT_EQUAL_UINT16((uint16_t)targets[i] << 8, stepped.getPosition());
+    }
+    TEST_ASSERT_GREATER_THAN(run.ticks, steppedTicks);
+}
+
+static void test_reversal_stops_on_waypoint(void) {
+    static const uint8_t targets[] = { 120, 60 };
+
+    TrajectoryPlanner planner;
+    planner.setLimits(360, 1800);
+    planner.reset(90);
+    planner.push(targets[0]);
+    planner.push(targets[1]);
+    Run run = runPlanner(planner, targets, 2);
+
+    // The turning point is a stop, so it is hit exactly
+    TEST_ASSERT_TRUE(run.landed[0]);
+    TEST_ASSERT_TRUE(run.landed[1]);
+    TEST_ASSERT_LESS_OR_EQUAL(accelPerTick(1800), run.maxAccel);
+    TEST_ASSERT_EQUAL_UINT16(60 << 8, planner.getPosition());
+}
+
+static void test_random_waypoints(void) {
+    srand(1);
+    for (uint16_t trial = 0; trial < 2000; trial++) {
+        uint16_t speed = 30 + rand() % 600;
+        uint16_t accel = 100 + rand() % 5000;
+        uint8_t count = 1 + rand() % PLANNER_WAYPOINTS;
+        uint8_t targets[PLANNER_WAYPOINTS];
+        for (uint8_t i = 0; i < count; i++) targets[i] = rand() % 181;
+
+        TrajectoryPlanner planner;
+        planner.setLimits(speed, accel);
+        uint8_t start = rand() % 181;
+        planner.reset(start);
+        for (uint8_t i = 0; i < count; i++) planner.push(targets[i]);
+        Run run = runPlanner(planner, targets, count);
+
+        TEST_ASSERT_FALSE(planner.isMoving());
+        TEST_ASSERT_LESS_OR_EQUAL(speedPerTick(speed), run.maxSpeed);
+        TEST_ASSERT_LESS_OR_EQUAL(accelPerTick(accel), run.maxAccel);
+        for (uint8_t i = 0; i < count; i++) TEST_ASSERT_TRUE(run.passed[i]);
+        TEST_ASSERT_EQUAL_UINT16((uint16_t)targets[count - 1] << 8, planner.getPosition());
+
+        // Every turning point is a stop, so it is hit exactly
+        int from = start;
+        int dir = 0;
+        for (uint8_t i = 0; i + 1 < count; i++) {
+            if (targets[i] != from) dir = targets[i] > from ? 1 : -1;
+            int out = targets[i + 1] - targets[i];
+            if (dir * out < 0) TEST_ASSERT_TRUE(run.landed[i]);
+            from = targets[i];
+        }
+    }
+}
+
+static void test_smooth_move_keeps_arm_limit(void) {
+    MotionController motion;
+    ArmController arms(motion, PIN_LEFT_ARM, PIN_RIGHT_ARM);
+    arms.begin();
+    size_t first = sim::trace().size();
+
+    // Speed 1 asks for 1000 deg/s; the arms must stay at ARM_MAX_SPEED
+    arms.smoothMove(180, 0, 1);
+    TEST_ASSERT_EQUAL_UINT8(180, arms.getLeftAngle());
+
+    // Angles are whole degrees, so allow the rounding of two positions
+    int32_t limit = (ARM_MAX_SPEED * MOTION_INTERVAL + 999) / 1000;
+    int32_t last = -1;
+    int32_t maxStep = 0;
+    const std::vector<sim::TraceRecord>& trace = sim::trace();
+    for (size_t i = first; i < trace.size(); i++) {
+        if (trace[i].event != sim::Event::SERVO_WRITE || trace[i].pin != PIN_LEFT_ARM) continue;
+        if (last >= 0 && labs(trace[i].value - last) > maxStep) maxStep = labs(trace[i].value - last);
+        last = trace[i].value;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(limit, maxStep);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_moves_respect_limits);
+    RUN_TEST(test_default_move_profile);
+    RUN_TEST(test_same_direction_moves_blend);
+    RUN_TEST(test_reversal_stops_on_waypoint);
+    RUN_TEST(test_random_waypoints);
+    RUN_TEST(test_smooth_move_keeps_arm_limit);
+    return UNITY_END();
+}
@@ -0,0 +1,136 @@
+"""
+RAM and flash footprint report for SBot.
+
+Builds each firmware env and reads the RAM/flash usage PlatformIO prints.
+With --against it also builds another git revision in a temporary
+worktree and prints the two side by side. --baseline compares with a
+report saved earlier by --output instead, without rebuilding it.
+
+Requires PlatformIO (pio) on the PATH.
+
+    python tools/footprint.py
+    python tools/footprint.py --against HEAD~1
+    python tools/footprint.py --env voice --output footprint.json
+    python tools/footprint.py --baseline footprint.json
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+DEFAULT_ENVS = ["voice", "autoplay", "voice_mega", "autoplay_mega"]
+
+USAGE_RE = re.compile(r"(RAM|Flash):.*\(used (\d+) bytes from (\d+) bytes\)")
+
+
+def find_pio():
+    pio = shutil.which("pio") or shutil.which("platformio")
+    if pio is None:
+        sys.exit("footprint: PlatformIO (pio) not found")
+    return pio
+
+
+def measure(project_dir, env, pio):
+    """Build one env and return {"ram": n, "flash": n, ...} or None on failure."""
+    proc = subprocess.run([pio, "run", "-e", env], cwd=project_dir,
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True)
+    if proc.returncode != 0:
+        print("footprint: %s failed to build in %s" % (env, project_dir), file=sys.stderr)
+        return None
+
+    usage = {}
+    for kind, used, total in USAGE_RE.findall(proc.stdout):
+        usage[kind.lower()] = int(used)
+        usage[kind.lower() + "_total"] = int(total)
+    return usage or None
+
+
+def measure_all(project_dir, envs, pio):
+    return {env: measure(project_dir, env, pio) for env in envs}
+
+
+def measure_revision(rev, envs, pio):
+    """Build envs at another git revision using a temporary worktree."""
+    tmp = tempfile.mkdtemp(prefix="sbot-footprint-")
+    worktree = os.path.join(tmp, "tree")
+    subprocess.run(["git", "worktree", "add", "--detach", worktree, rev],
+                   cwd=PROJECT_DIR, check=True, stdout=subprocess.DEVNULL)
+    try:
+        return measure_all(worktree, envs, pio)
+    finally:
+        subprocess.run(["git", "worktree", "remove", "--force", worktree], cwd=PROJECT_DIR)
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+def fmt(value):
+    return "-" if value is None else str(value)
+
+
+def fmt_delta(before, after):
+    if before is None or after is None:
+        return ""
+    return "%+d" % (after - before)
+
+
+def print_table(current, before=None):
+    if before is None:
+        print("%-15s %8s %8s" % ("env", "RAM", "flash"))
+        for env, usage in current.items():
+            usage = usage or {}
+            print("%-15s %8s %8s" % (env, fmt(usage.get("ram")), fmt(usage.get("flash"))))
+        return
+
+    print("%-15s %8s %8s %7s   %8s %8s %7s" %
+          ("env", "RAM old", "RAM new", "delta", "fl. old", "fl. new", "delta"))
+    for env, usage in current.items():
+        usage = usage or {}
+        old = before.get(env) or {}
+        print("%-15s %8s %8s %7s   %8s %8s %7s" % (
+            env,
+            fmt(old.get("ram")), fmt(usage.get("ram")),
+            fmt_delta(old.get("ram"), usage.get("ram")),
+            fmt(old.get("flash")), fmt(usage.get("flash")),
+            fmt_delta(old.get("flash"), usage.get("flash"))))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report SBot RAM/flash usage per env")
+    parser.add_argument("--env", action="append", help="env to measure (default: firmware envs)")
+    parser.add_argument("--against", metavar="REV", help="git revision to compare with")
+    parser.add_argument("--baseline", metavar="FILE", help="saved --output report to compare with")
+    parser.add_argument("--output", help="write the report as JSON")
+    args = parser.parse_args()
+    if args.against and args.baseline:
+        parser.error("use either --against or --baseline")
+
+    pio = find_pio()
+    envs = args.env or DEFAULT_ENVS
+
+    before = None
+    if args.against:
+        before = measure_revision(args.against, envs, pio)
+    elif args.baseline:
+        with open(args.baseline) as f:
+            before = json.load(f)["current"]
+    current = measure_all(PROJECT_DIR, envs, pio)
+
+    print_table(current, before)
+
+    if args.output:
+        report = {"current": current}
+        if before is not None:
+            report["against"] = {"rev": args.against, "usage": before}
+        with open(args.output, "w") as f:
+            json.dump(report, f, indent=2, sort_keys=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,197 @@
+"""
+RTTTL melody compiler for SBot.
+
+Turns every RTTTL string in include/melodies.h into packed 16-bit note
+records stored in PROGMEM. include/melodies_compiled.h declares the note
+arrays and the SONG_* descriptors; src/melodies_compiled.cpp defines the
+arrays, so each melody is in flash once however many files include the
+header. The player then needs no text parsing at run time, and each
+melody's exact duration is known at compile time.
+
+Record layout (uint16_t):
+    bits 0-3   note      0 = pause, 1-12 = C..B
+    bits 4-6   octave    0-7
+    bits 7-9   duration  log2 of the divisor (1, 2, 4 ... 32)
+    bit  10    dotted
+
+Runs automatically as a PlatformIO pre-build script, or by hand:
+    python tools/rtttl_compile.py
+"""
+
+import os
+import re
+import sys
+
+NOTE_INDEX = {"p": 0, "c": 1, "d": 3, "e": 5, "f": 6, "g": 8, "a": 10, "b": 12}
+DURATION_CODES = {1: 0, 2: 1, 4: 2, 8: 3, 16: 4, 32: 5}
+
+MELODY_RE = re.compile(
+    r"const\s+char\s+(MELODY_\w+)\s*\[\]\s*PROGMEM\s*=\s*((?:\s*\"[^\"]*\")+)\s*;")
+
+
+class RtttlError(Exception):
+    pass
+
+
+def parse_rtttl(text):
+    """Parse one RTTTL string into (whole_note_ms, [(note, octave, code, dotted)])."""
+    try:
+        _name, defaults, body = text.split(":", 2)
+    except ValueError:
+        raise RtttlError("missing ':' sections")
+
+    duration, octave, bpm = 4, 6, 63
+    for item in defaults.split(","):
+        key, _, value = item.strip().partition("=")
+        if key == "d":
+            duration = int(value)
+        elif key == "o":
+            octave = int(value)
+        elif key == "b":
+            bpm = int(value)
+
+    notes = []
+    for token in body.split(","):
+        token = token.strip()
+        if not token:
+            continue
+        m = re.fullmatch(r"(\d*)([pcdefgab])(#?)(\.?)(\d?)(\.?)", token)
+        if not m:
+            raise RtttlError("bad note '%s'" % token)
+        dur = int(m.group(1)) if m.group(1) else duration
+        if dur not in DURATION_CODES:
+            raise RtttlError("unsupported duration %d in '%s'" % (dur, token))
+        note = NOTE_INDEX[m.group(2)] + (1 if m.group(3) else 0)
+        oct_ = int(m.group(5)) if m.group(5) else octave
+        if not 0 <= oct_ <= 7:
+            raise RtttlError("octave out of range in '%s'" % token)
+        dotted = bool(m.group(4) or m.group(6))
+        notes.append((note, oct_, DURATION_CODES[dur], dotted))
+
+    return (60000 * 4) // bpm, notes
+
+
+def note_ms(whole, code, dotted):
+    """Duration exactly as RtttlPlayer computes it."""
+    ms = whole >> code
+    if dotted:
+        ms += ms // 2
+    return ms
+
+
+def parse_melodies(source):
+    melodies = []
+    for name, literal in MELODY_RE.findall(source):
+        text = "".join(re.findall(r"\"([^\"]*)\"", literal))
+        try:
+            whole, notes = parse_rtttl(text)
+        except RtttlError as err:
+            raise RtttlError("%s: %s" % (name, err))
+        melodies.append((name, whole, notes))
+    return melodies
+
+
+def song_name(name):
+    return "SONG_" + name[len("MELODY_"):]
+
+
+def song_summary(name, whole, notes):
+    total = sum(note_ms(whole, c, d) for _n, _o, c, d in notes)
+    return total, "// %s: %d notes, %d bytes, %d ms" % (name, len(notes), 2 * len(notes), total)
+
+
+def compile_header(melodies):
+    out = []
+    out.append("/**")
+    out.append(" * @file melodies_compiled.h")
+    out.append(" * @brief Pre-compiled note streams for the melodies in melodies.h")
+    out.append(" * @version 1.0.0")
+    out.append(" * ")
+    out.append(" * GENERATED by tools/rtttl_compile.py - do not edit by hand.")
+    out.append(" * The note arrays are defined in melodies_compiled.cpp.")
+    out.append(" */")
+    out.append("")
+    out.append("#ifndef SBOT_MELODIES_COMPILED_H")
+    out.append("#define SBOT_MELODIES_COMPILED_H")
+    out.append("")
+    out.append("#include <PlayRtttl.hpp>")
+
+    for name, whole, notes in melodies:
+        song = song_name(name)
+        total, summary = song_summary(name, whole, notes)
+
+        out.append("")
+        out.append(summary)
+        out.append("extern const uint16_t %s_NOTES[] PROGMEM;" % song)
+        out.append("constexpr RtttlSong %s = { %s_NOTES, %d, %d, %dUL };"
+                   % (song, song, len(notes), whole, total))
+
+    out.append("")
+    out.append("#endif // SBOT_MELODIES_COMPILED_H")
+    out.append("")
+    return "\n".join(out)
+
+
+def compile_source(melodies):
+    out = []
+    out.append("/**")
+    out.append(" * @file melodies_compiled.cpp")
+    out.append(" * @brief Note streams declared in melodies_compiled.h")
+    out.append(" * @version 1.0.0")
+    out.append(" * ")
+    out.append(" * GENERATED by tools/rtttl_compile.py - do not edit by hand.")
+    out.append(" */")
+    out.append("")
+    out.append("#include \"melodies_compiled.h\"")
+
+    for name, whole, notes in melodies:
+        song = song_name(name)
+        _total, summary = song_summary(name, whole, notes)
+        words = ["0x%04X" % (n | (o << 4) | (c << 7) | (int(d) << 10))
+                 for n, o, c, d in notes]
+
+        out.append("")
+        out.append(summary)
+        out.append("const uint16_t %s_NOTES[] PROGMEM = {" % song)
+        for i in range(0, len(words), 8):
+            out.append("    " + ", ".join(words[i:i + 8]) + ",")
+        out.append("};")
+
+    out.append("")
+    return "\n".join(out)
+
+
+def write_if_changed(path, text, project_dir):
+    old = None
+    if os.path.exists(path):
+        with open(path) as f:
+            old = f.read()
+
+    # Only touch the file when it changes, to avoid needless rebuilds
+    if text != old:
+        with open(path, "w") as f:
+            f.write(text)
+        print("rtttl_compile: wrote %s" % os.path.relpath(path, project_dir))
+
+
+def main(project_dir):
+    src = os.path.join(project_dir, "include", "melodies.h")
+
+    with open(src) as f:
+        melodies = parse_melodies(f.read())
+
+    write_if_changed(os.path.join(project_dir, "include", "melodies_compiled.h"),
+                     compile_header(melodies), project_dir)
+    write_if_changed(os.path.join(project_dir, "src", "melodies_compiled.cpp"),
+                     compile_source(melodies), project_dir)
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    main(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        try:
+            main(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+        except RtttlError as err:
+            sys.exit("rtttl_compile: %s" % err)
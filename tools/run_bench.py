@@ -0,0 +1,138 @@
+"""
+AVR cycle benchmark runner for SBot.
+
+Builds the bench firmware (bench/bench_main.cpp) for each benchmark env,
+runs it in simavr and collects the cycles-per-call figures it prints.
+Writes a JSON report and, given a baseline report, fails when a hot path
+got slower than the allowed tolerance.
+
+Requires PlatformIO (pio) and simavr on the PATH.
+
+    python tools/run_bench.py
+    python tools/run_bench.py --baseline bench_baseline.json --tolerance 5
+    python tools/run_bench.py --env bench_uno --output report.json
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# PlatformIO env -> simavr MCU name
+BENCH_ENVS = {
+    "bench_uno": "atmega328p",
+    "bench_mega": "atmega2560",
+}
+
+F_CPU = 16000000
+SIM_TIMEOUT_S = 120
+
+ANSI_RE = re.compile(r"\x1b\[[0-9;]*m")
+BEGIN_RE = re.compile(r"BENCH_BEGIN f_cpu=(\d+) overhead=(\d+)")
+RESULT_RE = re.compile(r"BENCH (\w+) calls=(\d+) cycles=(\d+)")
+
+
+def build(env):
+    pio = shutil.which("pio") or shutil.which("platformio")
+    if pio is None:
+        sys.exit("run_bench: PlatformIO (pio) not found")
+    subprocess.run([pio, "run", "-e", env], cwd=PROJECT_DIR, check=True)
+    return os.path.join(PROJECT_DIR, ".pio", "build", env, "firmware.elf")
+
+
+def simulate(elf, mcu):
+    simavr = shutil.which("simavr")
+    if simavr is None:
+        sys.exit("run_bench: simavr not found")
+    proc = subprocess.run([simavr, "-m", mcu, "-f", str(F_CPU), elf],
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True, timeout=SIM_TIMEOUT_S)
+    return ANSI_RE.sub("", proc.stdout)
+
+
+def parse(output, env):
+    begin = BEGIN_RE.search(output)
+    if begin is None or "BENCH_END" not in output:
+        sys.exit("run_bench: %s did not complete, simavr output:\n%s" % (env, output))
+
+    f_cpu = int(begin.group(1))
+    results = {}
+    for name, calls, cycles in RESULT_RE.findall(output):
+        cycles = int(cycles)
+        results[name] = {
+            "calls": int(calls),
+            "cycles": cycles,
+            "us": round(cycles * 1e6 / f_cpu, 2),
+        }
+    return {
+        "mcu": BENCH_ENVS[env],
+        "f_cpu": f_cpu,
+        "call_overhead": int(begin.group(2)),
+        "results": results,
+    }
+
+
+def print_table(report):
+    for env, data in report.items():
+        print("\n%s (%s @ %d MHz)" % (env, data["mcu"], data["f_cpu"] // 1000000))
+        print("  %-22s %10s %10s" % ("benchmark", "cycles", "us"))
+        for name, r in data["results"].items():
+            print("  %-22s %10d %10.2f" % (name, r["cycles"], r["us"]))
+
+
+def compare(report, baseline, tolerance):
+    """Return a list of regressions beyond tolerance percent."""
+    regressions = []
+    for env, data in report.items():
+        old = baseline.get(env, {}).get("results", {})
+        for name, r in data["results"].items():
+            if name not in old or old[name]["cycles"] == 0:
+                continue
+            change = 100.0 * (r["cycles"] - old[name]["cycles"]) / old[name]["cycles"]
+            if change > tolerance:
+                regressions.append("%s/%s: %d -> %d cycles (+%.1f%%)"
+                                   % (env, name, old[name]["cycles"], r["cycles"], change))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run SBot AVR cycle benchmarks in simavr")
+    parser.add_argument("--env", action="append", choices=sorted(BENCH_ENVS),
+                        help="benchmark env to run (default: all)")
+    parser.add_argument("--output", default=os.path.join(PROJECT_DIR, ".pio", "bench_report.json"),
+                        help="JSON report path")
+    parser.add_argument("--baseline", help="previous report to compare against")
+    parser.add_argument("--tolerance", type=float, default=5.0,
+                        help="allowed slowdown in percent before failing (default 5)")
+    args = parser.parse_args()
+
+    report = {}
+    for env in args.env or sorted(BENCH_ENVS):
+        elf = build(env)
+        report[env] = parse(simulate(elf, BENCH_ENVS[env]), env)
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "w") as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+
+    print_table(report)
+    print("\nReport written to %s" % os.path.relpath(args.output, PROJECT_DIR))
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions = compare(report, json.load(f), args.tolerance)
+        if regressions:
+            print("\nRegressions:")
+            for line in regressions:
+                print("  " + line)
+            sys.exit(1)
+        print("No regressions beyond %.1f%%" % args.tolerance)
+
+
+if __name__ == "__main__":
+    main()